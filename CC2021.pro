@@ -26,6 +26,9 @@ QT += svg
 QT += core
 QT += quick
 QT += widgets
+QT += network
+QT += serialport
+QT += concurrent
 QT += quickcontrols2
 
 QTPLUGIN += qsvg
@@ -43,6 +46,14 @@ QTPLUGIN += qsvg
     QMAKE_CXXFLAGS_RELEASE -= /O
     QMAKE_CXXFLAGS_RELEASE *= /O2
 }
+
+#-------------------------------------------------------------------------------
+# Instrumentation profiler (qmake CONFIG+=profiler)
+#-------------------------------------------------------------------------------
+
+profiler {
+    DEFINES += CC2021_PROFILER
+}
     
 #-------------------------------------------------------------------------------
 # Libraries
@@ -57,6 +68,7 @@ include(libs/Libraries.pri)
 win32* {
     RC_FILE = deploy/windows/resources/info.rc
     OTHER_FILES += deploy/windows/nsis/setup.nsi
+    LIBS += -lpsapi
 }
 
 macx* {
@@ -90,12 +102,70 @@ DISTFILES += \
 
 HEADERS += \
     src/AppInfo.h \
+    src/Misc/LogViewer.h \
+    src/Misc/Metrics.h \
+    src/Misc/MetricsServer.h \
+    src/Misc/Profiler.h \
+    src/Misc/RenderStats.h \
+    src/Misc/StartupTrace.h \
     src/Misc/Utilities.h \
     src/Misc/TimerEvents.h \
-    src/SerialStudio/Communicator.h
+    src/Misc/Watchdog.h \
+    src/Mission/Expression.h \
+    src/Mission/PressureProfile.h \
+    src/Mission/ProfileLibrary.h \
+    src/Mission/RuleEngine.h \
+    src/Mission/Timeline.h \
+    src/SerialStudio/CommandTracker.h \
+    src/SerialStudio/Communicator.h \
+    src/SerialStudio/Link.h \
+    src/SerialStudio/LocalTransport.h \
+    src/SerialStudio/LoopbackTransport.h \
+    src/SerialStudio/SerialTransport.h \
+    src/SerialStudio/SessionArchive.h \
+    src/SerialStudio/SessionRecorder.h \
+    src/SerialStudio/State.h \
+    src/SerialStudio/StressTest.h \
+    src/SerialStudio/TcpTransport.h \
+    src/SerialStudio/Transport.h \
+    src/SerialStudio/UdpTransport.h \
+    src/SerialStudio/XBee.h \
+    src/Telemetry/Analytics.h \
+    src/Telemetry/CsvWriter.h \
+    src/Telemetry/Packet.h \
+    src/Telemetry/SequenceWindow.h
 
 SOURCES += \
     src/main.cpp \
+    src/Misc/LogViewer.cpp \
+    src/Misc/Metrics.cpp \
+    src/Misc/MetricsServer.cpp \
+    src/Misc/Profiler.cpp \
+    src/Misc/RenderStats.cpp \
+    src/Misc/StartupTrace.cpp \
     src/Misc/Utilities.cpp \
     src/Misc/TimerEvents.cpp \
-    src/SerialStudio/Communicator.cpp
+    src/Misc/Watchdog.cpp \
+    src/Mission/Expression.cpp \
+    src/Mission/PressureProfile.cpp \
+    src/Mission/ProfileLibrary.cpp \
+    src/Mission/RuleEngine.cpp \
+    src/Mission/Timeline.cpp \
+    src/SerialStudio/CommandTracker.cpp \
+    src/SerialStudio/Communicator.cpp \
+    src/SerialStudio/Link.cpp \
+    src/SerialStudio/LocalTransport.cpp \
+    src/SerialStudio/LoopbackTransport.cpp \
+    src/SerialStudio/SerialTransport.cpp \
+    src/SerialStudio/SessionArchive.cpp \
+    src/SerialStudio/SessionRecorder.cpp \
+    src/SerialStudio/State.cpp \
+    src/SerialStudio/StressTest.cpp \
+    src/SerialStudio/TcpTransport.cpp \
+    src/SerialStudio/Transport.cpp \
+    src/SerialStudio/UdpTransport.cpp \
+    src/SerialStudio/XBee.cpp \
+    src/Telemetry/Analytics.cpp \
+    src/Telemetry/CsvWriter.cpp \
+    src/Telemetry/Packet.cpp \
+    src/Telemetry/SequenceWindow.cpp
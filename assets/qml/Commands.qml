@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick 2.12
+import QtQuick.Window 2.12
+import QtQuick.Layouts 1.12
+import QtQuick.Controls 2.12
+import QtQuick.Controls.Universal 2.12
+
+ApplicationWindow {
+    id: root
+
+    //
+    // Window options
+    //
+    width: minimumWidth
+    height: minimumHeight
+    minimumWidth: 520
+    minimumHeight: 360
+    title: qsTr("Command Acknowledgements")
+
+    //
+    // Theme options
+    //
+    Universal.theme: Universal.Dark
+    Universal.accent: Universal.Amber
+
+    //
+    // Window contents
+    //
+    ColumnLayout {
+        spacing: app.spacing
+        anchors.fill: parent
+        anchors.margins: 2 * app.spacing
+
+        //
+        // Retry options
+        //
+        RowLayout {
+            spacing: app.spacing
+            Layout.fillWidth: true
+
+            Label {
+                text: qsTr("Timeout (ms)") + ":"
+                Layout.alignment: Qt.AlignVCenter
+            }
+
+            SpinBox {
+                from: 500
+                to: 30000
+                stepSize: 500
+                editable: true
+                value: Cpp_SerialStudio_CommandTracker.ackTimeout
+                onValueModified: Cpp_SerialStudio_CommandTracker.ackTimeout = value
+            }
+
+            Label {
+                text: qsTr("Attempts") + ":"
+                Layout.alignment: Qt.AlignVCenter
+            }
+
+            SpinBox {
+                from: 1
+                to: 10
+                editable: true
+                value: Cpp_SerialStudio_CommandTracker.maxAttempts
+                onValueModified: Cpp_SerialStudio_CommandTracker.maxAttempts = value
+            }
+
+            Item {
+                Layout.fillWidth: true
+            }
+
+            Button {
+                text: qsTr("Clear")
+                onClicked: Cpp_SerialStudio_CommandTracker.clear()
+            }
+        }
+
+        //
+        // Command list
+        //
+        ListView {
+            id: listView
+            clip: true
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            model: Cpp_SerialStudio_CommandTracker
+
+            delegate: RowLayout {
+                spacing: app.spacing
+                width: listView.width
+
+                Label {
+                    opacity: 0.8
+                    text: model.sentAt
+                    font.family: app.monoFont
+                }
+
+                Label {
+                    text: model.command
+                    Layout.fillWidth: true
+                    font.family: app.monoFont
+                }
+
+                Label {
+                    font.family: app.monoFont
+                    text: model.attempts > 1 ? "x" + model.attempts : ""
+                }
+
+                Label {
+                    opacity: 0.8
+                    text: model.delivery
+                }
+
+                Label {
+                    font.bold: true
+                    text: model.stateName
+                    color: model.state === 1 ? "#72d5a3" :
+                           model.state === 2 ? "#d57272" : "#e6e0b2"
+                }
+
+                Label {
+                    Layout.minimumWidth: 72
+                    font.family: app.monoFont
+                    horizontalAlignment: Label.AlignRight
+                    text: model.roundTripTime >= 0 ? model.roundTripTime + " ms" : ""
+                }
+            }
+        }
+    }
+}
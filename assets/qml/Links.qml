@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick 2.12
+import QtQuick.Window 2.12
+import QtQuick.Layouts 1.12
+import QtQuick.Controls 2.12
+import QtQuick.Controls.Universal 2.12
+
+ApplicationWindow {
+    id: root
+
+    //
+    // Window options
+    //
+    width: minimumWidth
+    height: minimumHeight
+    minimumWidth: 520
+    minimumHeight: 320
+    title: qsTr("Serial Studio Links")
+
+    //
+    // Theme options
+    //
+    Universal.theme: Universal.Dark
+    Universal.accent: Universal.Amber
+
+    //
+    // Window contents
+    //
+    ColumnLayout {
+        spacing: app.spacing
+        anchors.fill: parent
+        anchors.margins: 2 * app.spacing
+
+        //
+        // Link list
+        //
+        ListView {
+            id: listView
+            clip: true
+            spacing: app.spacing
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            model: Cpp_SerialStudio_Communicator.links
+
+            delegate: RowLayout {
+                spacing: app.spacing
+                width: listView.width
+
+                Rectangle {
+                    width: 12
+                    height: 12
+                    radius: 6
+                    Layout.alignment: Qt.AlignVCenter
+                    color: modelData.connected ? "#72d5a3" : "#d57272"
+                }
+
+                Label {
+                    font.bold: true
+                    font.family: app.monoFont
+                    Layout.alignment: Qt.AlignVCenter
+                    text: modelData.transport + "://" + modelData.host + ":" + modelData.port
+                }
+
+                Label {
+                    opacity: 0.8
+                    font.pixelSize: 11
+                    Layout.fillWidth: true
+                    font.family: app.monoFont
+                    Layout.alignment: Qt.AlignVCenter
+                    text: modelData.status + " | " +
+                          qsTr("Queue: %1").arg(modelData.queueDepth) + " | " +
+                          qsTr("TX: %1").arg(modelData.framesSent) + " | " +
+                          qsTr("RX: %1").arg(modelData.packetsReceived) + " | " +
+                          qsTr("Dropped: %1").arg(modelData.framesDropped) + " | " +
+                          qsTr("Reconnects: %1").arg(modelData.reconnects)
+                }
+
+                Button {
+                    icon.width: 16
+                    icon.height: 16
+                    icon.source: "qrc:/icons/close.svg"
+                    Layout.alignment: Qt.AlignVCenter
+                    onClicked: Cpp_SerialStudio_Communicator.removeLink(index)
+                }
+            }
+        }
+
+        Label {
+            opacity: 0.8
+            font.pixelSize: 11
+            text: qsTr("Duplicated packets discarded: %1").arg(
+                      Cpp_SerialStudio_Communicator.duplicatePackets)
+        }
+
+        Label {
+            opacity: 0.8
+            font.pixelSize: 11
+            text: qsTr("Metrics endpoint: %1").arg(Cpp_Misc_Metrics.endpoint)
+        }
+
+        //
+        // Flight files
+        //
+        RowLayout {
+            spacing: app.spacing
+            Layout.fillWidth: true
+
+            CheckBox {
+                text: qsTr("Write flight CSV files")
+                checked: Cpp_Telemetry_CsvWriter.enabled
+                onCheckedChanged: Cpp_Telemetry_CsvWriter.enabled = checked
+            }
+
+            Label {
+                Layout.alignment: Qt.AlignVCenter
+                text: qsTr("Sync every (ms)") + ":"
+            }
+
+            SpinBox {
+                from: 100
+                to: 60000
+                stepSize: 100
+                editable: true
+                value: Cpp_Telemetry_CsvWriter.syncInterval
+                onValueModified: Cpp_Telemetry_CsvWriter.syncInterval = value
+            }
+
+            Item {
+                Layout.fillWidth: true
+            }
+
+            Button {
+                text: qsTr("Open folder")
+                onClicked: Cpp_Telemetry_CsvWriter.openDirectory()
+            }
+        }
+
+        Label {
+            color: "#d57272"
+            font.pixelSize: 11
+            Layout.fillWidth: true
+            wrapMode: Label.WordWrap
+            text: Cpp_Telemetry_CsvWriter.errorString
+            visible: Cpp_Telemetry_CsvWriter.errorString.length > 0
+        }
+
+        //
+        // Session archive
+        //
+        RowLayout {
+            spacing: app.spacing
+            Layout.fillWidth: true
+
+            CheckBox {
+                text: qsTr("Record session archive")
+                checked: Cpp_SerialStudio_SessionRecorder.enabled
+                onCheckedChanged: Cpp_SerialStudio_SessionRecorder.enabled = checked
+            }
+
+            Label {
+                opacity: 0.8
+                font.pixelSize: 11
+                elide: Label.ElideRight
+                Layout.fillWidth: true
+                Layout.alignment: Qt.AlignVCenter
+                text: Cpp_SerialStudio_SessionRecorder.statistics
+                ToolTip.visible: hovered && Cpp_SerialStudio_SessionRecorder.enabled
+                ToolTip.text: Cpp_SerialStudio_SessionRecorder.fileName
+            }
+        }
+
+        //
+        // New link controls
+        //
+        RowLayout {
+            spacing: app.spacing
+            Layout.fillWidth: true
+
+            ComboBox {
+                id: transport
+                model: Cpp_SerialStudio_Communicator.availableTransports
+            }
+
+            TextField {
+                id: host
+                text: "127.0.0.1"
+                Layout.fillWidth: true
+                font.family: app.monoFont
+                placeholderText: transport.currentText === "Serial" ?
+                                     qsTr("Port name, e.g. /dev/ttyUSB0@9600") :
+                                     qsTr("Host")
+            }
+
+            TextField {
+                id: port
+                text: "7777"
+                font.family: app.monoFont
+                Layout.maximumWidth: 80
+                placeholderText: qsTr("Port")
+                enabled: transport.currentText !== "Serial"
+                validator: IntValidator {
+                    bottom: 1
+                    top: 65535
+                }
+            }
+
+            Button {
+                text: qsTr("Add link")
+                icon.source: "qrc:/icons/radar.svg"
+                onClicked: Cpp_SerialStudio_Communicator.addLink(host.text,
+                                                                 parseInt(port.text),
+                                                                 transport.currentText)
+            }
+        }
+    }
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick 2.12
+import QtQuick.Window 2.12
+import QtQuick.Layouts 1.12
+import QtQuick.Controls 2.12
+import QtQuick.Controls.Universal 2.12
+
+ApplicationWindow {
+    id: root
+
+    //
+    // Window options
+    //
+    width: minimumWidth
+    height: minimumHeight
+    minimumWidth: 760
+    minimumHeight: 480
+    title: qsTr("Application Log")
+
+    //
+    // Theme options
+    //
+    Universal.theme: Universal.Dark
+    Universal.accent: Universal.Amber
+
+    //
+    // Map the log file only while the window is visible
+    //
+    onVisibleChanged: {
+        if (visible)
+            Cpp_Misc_LogViewer.open()
+        else
+            Cpp_Misc_LogViewer.close()
+    }
+
+    //
+    // Window contents
+    //
+    ColumnLayout {
+        spacing: app.spacing
+        anchors.fill: parent
+        anchors.margins: 2 * app.spacing
+
+        //
+        // Filter controls
+        //
+        RowLayout {
+            spacing: app.spacing
+            Layout.fillWidth: true
+
+            TextField {
+                Layout.fillWidth: true
+                font.family: app.monoFont
+                placeholderText: qsTr("Filter (case sensitive)")
+                onTextChanged: Cpp_Misc_LogViewer.filterText = text
+            }
+
+            Repeater {
+                model: [
+                    { "name": qsTr("Debug"), "mask": 0x01 },
+                    { "name": qsTr("Info"), "mask": 0x02 },
+                    { "name": qsTr("Warning"), "mask": 0x04 },
+                    { "name": qsTr("Error"), "mask": 0x08 }
+                ]
+
+                delegate: CheckBox {
+                    text: modelData.name
+                    checked: Cpp_Misc_LogViewer.levelFilter & modelData.mask
+                    onClicked: Cpp_Misc_LogViewer.levelFilter =
+                               Cpp_Misc_LogViewer.levelFilter ^ modelData.mask
+                }
+            }
+
+            Button {
+                text: qsTr("Reload")
+                onClicked: Cpp_Misc_LogViewer.open()
+            }
+
+            Button {
+                text: qsTr("Open externally")
+                onClicked: Cpp_Misc_Utilities.openLogFile()
+            }
+        }
+
+        //
+        // Log lines
+        //
+        ListView {
+            id: listView
+            clip: true
+            focus: true
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            model: Cpp_Misc_LogViewer
+            boundsBehavior: ListView.StopAtBounds
+
+            ScrollBar.vertical: ScrollBar {
+                id: scrollBar
+                policy: ScrollBar.AlwaysOn
+            }
+
+            Keys.onPressed: {
+                var page = Math.floor(height / 18)
+                if (event.key === Qt.Key_PageDown)
+                    positionViewAtIndex(Math.min(count - 1, indexAt(0, contentY) + page),
+                                        ListView.Beginning)
+                else if (event.key === Qt.Key_PageUp)
+                    positionViewAtIndex(Math.max(0, indexAt(0, contentY) - page),
+                                        ListView.Beginning)
+                else if (event.key === Qt.Key_Home)
+                    positionViewAtBeginning()
+                else if (event.key === Qt.Key_End)
+                    positionViewAtEnd()
+                else
+                    return
+
+                event.accepted = true
+            }
+
+            delegate: RowLayout {
+                height: 18
+                spacing: app.spacing
+                width: listView.width - scrollBar.width
+
+                Label {
+                    opacity: 0.6
+                    font.pixelSize: 11
+                    text: model.lineNumber
+                    font.family: app.monoFont
+                    Layout.minimumWidth: 64
+                    horizontalAlignment: Label.AlignRight
+                }
+
+                Label {
+                    font.pixelSize: 11
+                    text: model.text
+                    Layout.fillWidth: true
+                    elide: Label.ElideRight
+                    font.family: app.monoFont
+                    color: model.level === 0x08 ? "#d57272" :
+                           model.level === 0x04 ? "#e6e0b2" :
+                           model.level === 0x01 ? "#8c8c8c" : "#ffffff"
+                }
+            }
+        }
+
+        //
+        // Status
+        //
+        RowLayout {
+            spacing: app.spacing
+            Layout.fillWidth: true
+
+            BusyIndicator {
+                implicitWidth: 24
+                implicitHeight: 24
+                running: Cpp_Misc_LogViewer.indexing || Cpp_Misc_LogViewer.filtering
+            }
+
+            Label {
+                opacity: 0.8
+                font.pixelSize: 11
+                Layout.fillWidth: true
+                text: qsTr("%1 of %2 lines (%3)").arg(listView.count)
+                                                 .arg(Cpp_Misc_LogViewer.totalLines)
+                                                 .arg(Cpp_Misc_LogViewer.fileSize)
+            }
+        }
+    }
+}
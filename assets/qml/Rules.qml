@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick 2.12
+import QtQuick.Window 2.12
+import QtQuick.Layouts 1.12
+import QtQuick.Controls 2.12
+import QtQuick.Controls.Universal 2.12
+
+ApplicationWindow {
+    id: root
+
+    //
+    // Window options
+    //
+    width: minimumWidth
+    height: minimumHeight
+    minimumWidth: 640
+    minimumHeight: 360
+    title: qsTr("Automation Rules")
+
+    //
+    // Theme options
+    //
+    Universal.theme: Universal.Dark
+    Universal.accent: Universal.Amber
+
+    //
+    // Window contents
+    //
+    ColumnLayout {
+        spacing: app.spacing
+        anchors.fill: parent
+        anchors.margins: 2 * app.spacing
+
+        //
+        // File controls
+        //
+        RowLayout {
+            spacing: app.spacing
+            Layout.fillWidth: true
+
+            Button {
+                text: qsTr("Open rules")
+                onClicked: Cpp_Mission_RuleEngine.openRules()
+            }
+
+            Label {
+                Layout.fillWidth: true
+                elide: Label.ElideMiddle
+                Layout.alignment: Qt.AlignVCenter
+                text: Cpp_Mission_RuleEngine.fileName
+            }
+        }
+
+        //
+        // Rule list
+        //
+        ListView {
+            id: listView
+            clip: true
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            model: Cpp_Mission_RuleEngine
+
+            delegate: RowLayout {
+                spacing: app.spacing
+                width: listView.width
+
+                Switch {
+                    checked: model.armed
+                    Universal.accent: Universal.Red
+                    onClicked: Cpp_Mission_RuleEngine.setArmed(index, checked)
+                }
+
+                ColumnLayout {
+                    spacing: 0
+                    Layout.fillWidth: true
+
+                    Label {
+                        font.bold: true
+                        text: model.name + " → " + model.action +
+                              (model.once ? " (" + qsTr("once") + ")" : "")
+                    }
+
+                    Label {
+                        opacity: 0.8
+                        font.pixelSize: 11
+                        Layout.fillWidth: true
+                        elide: Label.ElideRight
+                        font.family: app.monoFont
+                        text: model.expression
+                    }
+                }
+
+                Label {
+                    font.bold: true
+                    color: model.result ? "#72d5a3" : "#e6e0b2"
+                    text: model.result ? qsTr("True") : qsTr("False")
+                }
+
+                Label {
+                    font.family: app.monoFont
+                    text: qsTr("Fired: %1").arg(model.fireCount)
+                }
+
+                Label {
+                    Layout.minimumWidth: 72
+                    text: model.cost
+                    font.family: app.monoFont
+                    horizontalAlignment: Label.AlignRight
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick 2.12
+import QtQuick.Window 2.12
+import QtQuick.Layouts 1.12
+import QtQuick.Controls 2.12
+import QtQuick.Controls.Universal 2.12
+
+ApplicationWindow {
+    id: root
+
+    //
+    // Window options
+    //
+    width: minimumWidth
+    height: minimumHeight
+    minimumWidth: 520
+    minimumHeight: 360
+    title: qsTr("Mission Timeline")
+
+    //
+    // Theme options
+    //
+    Universal.theme: Universal.Dark
+    Universal.accent: Universal.Amber
+
+    //
+    // Window contents
+    //
+    ColumnLayout {
+        spacing: app.spacing
+        anchors.fill: parent
+        anchors.margins: 2 * app.spacing
+
+        //
+        // Script controls
+        //
+        RowLayout {
+            spacing: app.spacing
+            Layout.fillWidth: true
+
+            Button {
+                text: qsTr("Open script")
+                enabled: !Cpp_Mission_Timeline.running
+                onClicked: Cpp_Mission_Timeline.openScript()
+            }
+
+            Label {
+                Layout.fillWidth: true
+                elide: Label.ElideMiddle
+                text: Cpp_Mission_Timeline.fileName
+                Layout.alignment: Qt.AlignVCenter
+            }
+
+            Label {
+                font.bold: true
+                font.family: app.monoFont
+                Layout.alignment: Qt.AlignVCenter
+                text: Cpp_Mission_Timeline.missionTime
+            }
+
+            Button {
+                enabled: listView.count > 0
+                text: Cpp_Mission_Timeline.running ? qsTr("Stop") : qsTr("Start")
+                onClicked: {
+                    if (Cpp_Mission_Timeline.running)
+                        Cpp_Mission_Timeline.stop()
+                    else
+                        Cpp_Mission_Timeline.start()
+                }
+            }
+        }
+
+        //
+        // Timeline entries
+        //
+        ListView {
+            id: listView
+            clip: true
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            model: Cpp_Mission_Timeline
+
+            delegate: RowLayout {
+                spacing: app.spacing
+                width: listView.width
+
+                Label {
+                    opacity: 0.8
+                    text: model.offset
+                    font.family: app.monoFont
+                    Layout.minimumWidth: 96
+                }
+
+                Label {
+                    text: model.description
+                    Layout.fillWidth: true
+                    font.family: app.monoFont
+                }
+
+                Label {
+                    font.bold: true
+                    color: model.state === 1 ? "#72d5a3" :
+                           model.state >= 2 ? "#d57272" : "#e6e0b2"
+                    text: model.state === 1 ? qsTr("Sent") :
+                          model.state === 2 ? qsTr("Skipped") :
+                          model.state === 3 ? qsTr("Failed") : qsTr("Waiting")
+                }
+
+                Label {
+                    Layout.minimumWidth: 72
+                    text: model.error
+                    font.family: app.monoFont
+                    horizontalAlignment: Label.AlignRight
+                }
+            }
+        }
+    }
+}
@@ -38,6 +38,7 @@ Page {
         Image {
             id: img
             opacity: 0.72
+            asynchronous: true
             anchors.fill: parent
             fillMode: Image.PreserveAspectCrop
             source: "qrc:/images/background.jpg"
@@ -46,7 +47,9 @@ Page {
         FastBlur {
             radius: 32
             source: img
+            cached: true
             anchors.fill: img
+            visible: img.status === Image.Ready
         }
 
         Rectangle {
@@ -94,6 +97,37 @@ Page {
                 font.pixelSize: 10
                 text: Cpp_AppName + " v" + Cpp_AppVersion
             }
+
+            Label {
+                opacity: 0.6
+                font.pixelSize: 10
+                font.family: app.monoFont
+                text: qsTr("%1 fps, %2 ms/frame, CPU %3%")
+                      .arg(Cpp_Misc_RenderStats.framesPerSecond)
+                      .arg(Cpp_Misc_RenderStats.frameTime.toFixed(2))
+                      .arg(Cpp_Misc_RenderStats.cpuUsage.toFixed(1))
+            }
+
+            Label {
+                font.pixelSize: 10
+                font.family: app.monoFont
+                opacity: 0.6
+                visible: Cpp_Misc_Watchdog !== null
+                text: visible ? qsTr("Event loop %1, %2 stalls")
+                                .arg(Cpp_Misc_Watchdog.latency)
+                                .arg(Cpp_Misc_Watchdog.stallCount) : ""
+
+                MouseArea {
+                    id: watchdogArea
+                    hoverEnabled: true
+                    anchors.fill: parent
+                }
+
+                ToolTip.visible: watchdogArea.containsMouse
+                ToolTip.text: !visible ? "" : Cpp_Misc_Watchdog.timers +
+                              (Cpp_Misc_Watchdog.stallCount > 0 ?
+                                   "\n\n" + Cpp_Misc_Watchdog.stalls.join("\n") : "")
+            }
         }
 
         Item {
@@ -106,12 +140,76 @@ Page {
             font.family: app.monoFont
             Layout.alignment: Qt.AlignVCenter
             text: Cpp_SerialStudio_Communicator.currentTime
+
+            MouseArea {
+                anchors.fill: parent
+                onClicked: {
+                    var precision = Cpp_SerialStudio_Communicator.clockPrecision
+                    Cpp_SerialStudio_Communicator.clockPrecision = (precision + 1) % 3
+                }
+            }
         }
 
         Item {
             Layout.fillWidth: true
         }
 
+        Button {
+            flat: true
+            icon.width: 24
+            icon.height: 24
+            onClicked: commandsWindow.show()
+            icon.source: "qrc:/icons/table.svg"
+            Layout.alignment: Qt.AlignVCenter
+            text: qsTr("Commands (%1 pending)").arg(
+                      Cpp_SerialStudio_CommandTracker.pendingCount)
+        }
+
+        Button {
+            flat: true
+            icon.width: 24
+            icon.height: 24
+            onClicked: timelineWindow.item.show()
+            enabled: timelineWindow.status === Loader.Ready
+            icon.source: "qrc:/icons/time.svg"
+            Layout.alignment: Qt.AlignVCenter
+            text: Cpp_Mission_Timeline && Cpp_Mission_Timeline.running ?
+                      Cpp_Mission_Timeline.missionTime : qsTr("Timeline")
+        }
+
+        Button {
+            flat: true
+            icon.width: 24
+            icon.height: 24
+            text: qsTr("Rules")
+            onClicked: rulesWindow.item.show()
+            enabled: rulesWindow.status === Loader.Ready
+            icon.source: "qrc:/icons/construction.svg"
+            Layout.alignment: Qt.AlignVCenter
+        }
+
+        Button {
+            flat: true
+            icon.width: 24
+            icon.height: 24
+            text: qsTr("Log")
+            onClicked: logWindow.item.show()
+            enabled: logWindow.status === Loader.Ready
+            icon.source: "qrc:/icons/bug.svg"
+            Layout.alignment: Qt.AlignVCenter
+        }
+
+        Button {
+            flat: true
+            icon.width: 24
+            icon.height: 24
+            text: qsTr("Links")
+            onClicked: linksWindow.item.show()
+            enabled: linksWindow.status === Loader.Ready
+            icon.source: "qrc:/icons/radar.svg"
+            Layout.alignment: Qt.AlignVCenter
+        }
+
         Label {
             Layout.alignment: Qt.AlignVCenter
             text: qsTr("Serial Studio Connection")
@@ -120,7 +218,7 @@ Page {
         Switch {
             Layout.alignment: Qt.AlignVCenter
             Universal.accent: Universal.Green
-            checked: Cpp_SerialStudio_Communicator.connectedToSerialStudio
+            checked: Cpp_SerialStudio_Communicator.state.connected
 
             MouseArea {
                 anchors.fill: parent
@@ -157,9 +255,9 @@ Page {
                 id: simModeEnabled
                 text: qsTr("Simulation mode")
 
-                checked: Cpp_SerialStudio_Communicator.simulationEnabled
-                enabled: Cpp_SerialStudio_Communicator.connectedToSerialStudio
-                onClicked: Cpp_SerialStudio_Communicator.simulationEnabled = !Cpp_SerialStudio_Communicator.simulationEnabled
+                checked: Cpp_SerialStudio_Communicator.state.simulationEnabled
+                enabled: Cpp_SerialStudio_Communicator.state.connected
+                onClicked: Cpp_SerialStudio_Communicator.setSimulationMode(!Cpp_SerialStudio_Communicator.state.simulationEnabled)
 
                 icon.width: 42
                 icon.height: 42
@@ -177,8 +275,8 @@ Page {
                 text: qsTr("Activate simulation mode")
 
                 enabled: simModeEnabled.checked && simModeEnabled.enabled
-                checked: Cpp_SerialStudio_Communicator.simulationActivated
-                onClicked: Cpp_SerialStudio_Communicator.simulationActivated = !Cpp_SerialStudio_Communicator.simulationActivated
+                checked: Cpp_SerialStudio_Communicator.state.simulationActivated
+                onClicked: Cpp_SerialStudio_Communicator.setSimulationActivated(!Cpp_SerialStudio_Communicator.state.simulationActivated)
 
                 icon.width: 42
                 icon.height: 42
@@ -196,9 +294,9 @@ Page {
 
                 text: qsTr("Container telemetry")
 
-                enabled: Cpp_SerialStudio_Communicator.connectedToSerialStudio
-                checked: Cpp_SerialStudio_Communicator.containerTelemetryEnabled
-                onClicked: Cpp_SerialStudio_Communicator.containerTelemetryEnabled = !Cpp_SerialStudio_Communicator.containerTelemetryEnabled
+                enabled: Cpp_SerialStudio_Communicator.state.connected
+                checked: Cpp_SerialStudio_Communicator.state.containerTelemetryEnabled
+                onClicked: Cpp_SerialStudio_Communicator.setContainerTelemetryEnabled(!Cpp_SerialStudio_Communicator.state.containerTelemetryEnabled)
 
                 icon.width: 42
                 icon.height: 42
@@ -217,7 +315,7 @@ Page {
                 text: qsTr("Update container time")
 
                 onClicked: Cpp_SerialStudio_Communicator.updateContainerTime()
-                enabled: Cpp_SerialStudio_Communicator.connectedToSerialStudio
+                enabled: Cpp_SerialStudio_Communicator.state.connected
 
                 icon.width: 42
                 icon.height: 42
@@ -236,9 +334,9 @@ Page {
                 checkable: true
                 text: qsTr("SP1 telemetry")
 
-                enabled: Cpp_SerialStudio_Communicator.connectedToSerialStudio
-                checked: Cpp_SerialStudio_Communicator.payload1TelemetryEnabled
-                onClicked: Cpp_SerialStudio_Communicator.payload1TelemetryEnabled = !Cpp_SerialStudio_Communicator.payload1TelemetryEnabled
+                enabled: Cpp_SerialStudio_Communicator.state.connected
+                checked: Cpp_SerialStudio_Communicator.state.payload1TelemetryEnabled
+                onClicked: Cpp_SerialStudio_Communicator.setPayload1TelemetryEnabled(!Cpp_SerialStudio_Communicator.state.payload1TelemetryEnabled)
 
                 icon.width: 42
                 icon.height: 42
@@ -257,7 +355,7 @@ Page {
                 text: qsTr("Release SP1")
 
                 onClicked: Cpp_SerialStudio_Communicator.releasePayload1()
-                enabled: Cpp_SerialStudio_Communicator.connectedToSerialStudio
+                enabled: Cpp_SerialStudio_Communicator.state.connected
 
                 icon.width: 42
                 icon.height: 42
@@ -276,9 +374,9 @@ Page {
                 checkable: true
                 text: qsTr("SP2 telemetry")
 
-                enabled: Cpp_SerialStudio_Communicator.connectedToSerialStudio
-                checked: Cpp_SerialStudio_Communicator.payload2TelemetryEnabled
-                onClicked: Cpp_SerialStudio_Communicator.payload2TelemetryEnabled = !Cpp_SerialStudio_Communicator.payload2TelemetryEnabled
+                enabled: Cpp_SerialStudio_Communicator.state.connected
+                checked: Cpp_SerialStudio_Communicator.state.payload2TelemetryEnabled
+                onClicked: Cpp_SerialStudio_Communicator.setPayload2TelemetryEnabled(!Cpp_SerialStudio_Communicator.state.payload2TelemetryEnabled)
 
                 icon.width: 42
                 icon.height: 42
@@ -297,7 +395,7 @@ Page {
                 text: qsTr("Release SP2")
 
                 onClicked: Cpp_SerialStudio_Communicator.releasePayload2()
-                enabled: Cpp_SerialStudio_Communicator.connectedToSerialStudio
+                enabled: Cpp_SerialStudio_Communicator.state.connected
 
                 icon.width: 42
                 icon.height: 42
@@ -333,10 +431,19 @@ Page {
                 onClicked: Cpp_SerialStudio_Communicator.openCsv()
             }
 
-            Label {
-                verticalAlignment: Label.AlignVCenter
-                horizontalAlignment: Label.AlignHCenter
-                text: "<" + Cpp_SerialStudio_Communicator.csvFileName + ">"
+            ComboBox {
+                textRole: "name"
+                enabled: count > 0
+                model: Cpp_Mission_ProfileLibrary
+                displayText: "<" + Cpp_SerialStudio_Communicator.state.csvFileName + ">"
+                onActivated: Cpp_SerialStudio_Communicator.selectProfile(index)
+
+                ToolTip.delay: 500
+                ToolTip.visible: hovered && ToolTip.text.length > 0
+                ToolTip.text: Cpp_SerialStudio_Communicator.state.profileReport.length > 0 ?
+                                  Cpp_SerialStudio_Communicator.state.profileReport + "\n\n" +
+                                  (Cpp_Mission_ProfileLibrary ?
+                                       Cpp_Mission_ProfileLibrary.memoryUsage : "") : ""
 
                 Layout.minimumWidth: grid.columnWidth
                 Layout.maximumWidth: grid.columnWidth
@@ -352,6 +459,27 @@ Page {
             Layout.fillWidth: true
             Layout.fillHeight: true
 
+            //
+            // Packet loss statistics
+            //
+            Repeater {
+                model: Cpp_Telemetry_Analytics ? Cpp_Telemetry_Analytics.sources : []
+                delegate: Label {
+                    font.pixelSize: 11
+                    Layout.fillWidth: true
+                    font.family: app.monoFont
+                    elide: Label.ElideRight
+                    color: modelData.lossRate > 5 ? "#d57272" : "#72d5a3"
+                    text: qsTr("%1: %2 rx, %3 lost (%4% / 60 s), jitter %5 ms, %6 bursts")
+                          .arg(modelData.name)
+                          .arg(modelData.received)
+                          .arg(modelData.lost)
+                          .arg(modelData.lossRate.toFixed(1))
+                          .arg(modelData.jitter.toFixed(1))
+                          .arg(modelData.bursts)
+                }
+            }
+
             RowLayout {
                 spacing: app.spacing
                 Layout.fillWidth: true
@@ -370,7 +498,7 @@ Page {
                     Layout.alignment: Qt.AlignVCenter
                     placeholderText: qsTr("No CSV data loaded")
 
-                    text: Cpp_SerialStudio_Communicator.currentSimulatedReading
+                    text: Cpp_SerialStudio_Communicator.state.currentSimulatedReading
 
                     background: Rectangle {
                         border.width: 1
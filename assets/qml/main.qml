@@ -64,6 +64,9 @@ ApplicationWindow {
     property bool firstChange: true
     property bool windowMaximized: false
     onVisibilityChanged: {
+        Cpp_SerialStudio_Communicator.clockPaused = (visibility === Window.Hidden ||
+                                                     visibility === Window.Minimized)
+
         if (visibility == Window.Maximized) {
             if (!windowMaximized)
                 firstChange = false
@@ -138,8 +141,23 @@ ApplicationWindow {
         if (appLaunchStatus == 2)
             automaticUpdatesMessageDialog.visible = true
 
-        // Check for updates (if we are allowed)
-        if (automaticUpdates)
+        // Check for updates (if we are allowed), the updater is initialized after the
+        // first frame is rendered
+        if (automaticUpdates) {
+            if (updaterAvailable)
+                Cpp_Updater.checkForUpdates(Cpp_AppUpdaterUrl)
+            else
+                checkForUpdatesWhenReady = true
+        }
+    }
+
+    //
+    // Check for updates once the deferred updater module is available
+    //
+    property bool checkForUpdatesWhenReady: false
+    readonly property bool updaterAvailable: Cpp_Updater !== null
+    onUpdaterAvailableChanged: {
+        if (updaterAvailable && checkForUpdatesWhenReady)
             Cpp_Updater.checkForUpdates(Cpp_AppUpdaterUrl)
     }
 
@@ -174,7 +192,10 @@ ApplicationWindow {
         // Behavior when the user clicks on "Yes"
         onAccepted: {
             app.automaticUpdates = true
-            Cpp_Updater.checkForUpdates(Cpp_AppUpdaterUrl)
+            if (app.updaterAvailable)
+                Cpp_Updater.checkForUpdates(Cpp_AppUpdaterUrl)
+            else
+                app.checkForUpdatesWhenReady = true
         }
 
         // Behavior when the user clicks on "No"
@@ -183,6 +204,49 @@ ApplicationWindow {
         }
     }
 
+    //
+    // Serial Studio links window, created with the deferred modules
+    //
+    Loader {
+        id: linksWindow
+        active: Cpp_ModulesReady
+        sourceComponent: Links {}
+    }
+
+    //
+    // Command acknowledgements window
+    //
+    Commands {
+        id: commandsWindow
+    }
+
+    //
+    // Mission timeline window, created with the deferred modules
+    //
+    Loader {
+        id: timelineWindow
+        active: Cpp_ModulesReady
+        sourceComponent: Timeline {}
+    }
+
+    //
+    // Application log window, created with the deferred modules
+    //
+    Loader {
+        id: logWindow
+        active: Cpp_ModulesReady
+        sourceComponent: LogViewer {}
+    }
+
+    //
+    // Automation rules window, created with the deferred modules
+    //
+    Loader {
+        id: rulesWindow
+        active: Cpp_ModulesReady
+        sourceComponent: Rules {}
+    }
+
     //
     // UI content
     //
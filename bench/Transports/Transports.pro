@@ -0,0 +1,68 @@
+#-------------------------------------------------------------------------------
+# Make options
+#-------------------------------------------------------------------------------
+
+UI_DIR = uic
+MOC_DIR = moc
+RCC_DIR = qrc
+OBJECTS_DIR = obj
+
+CONFIG += c++11
+
+#-------------------------------------------------------------------------------
+# Qt configuration
+#-------------------------------------------------------------------------------
+
+TEMPLATE = app
+TARGET = transport-bench
+
+CONFIG += console
+CONFIG -= app_bundle
+
+QT += core
+QT += network
+QT += serialport
+
+#-------------------------------------------------------------------------------
+# Compiler options
+#-------------------------------------------------------------------------------
+
+*g++*: {
+    QMAKE_CXXFLAGS_RELEASE -= -O
+    QMAKE_CXXFLAGS_RELEASE *= -O3
+}
+
+*msvc*: {
+    QMAKE_CXXFLAGS_RELEASE -= /O
+    QMAKE_CXXFLAGS_RELEASE *= /O2
+}
+
+#-------------------------------------------------------------------------------
+# Libraries
+#-------------------------------------------------------------------------------
+
+DEFINES += CUTELOGGER_SRC
+include($$PWD/../../libs/CuteLogger/CuteLogger.pri)
+
+#-------------------------------------------------------------------------------
+# Import source code
+#-------------------------------------------------------------------------------
+
+INCLUDEPATH += $$PWD/../../src
+
+HEADERS += \
+    ../../src/SerialStudio/LocalTransport.h \
+    ../../src/SerialStudio/LoopbackTransport.h \
+    ../../src/SerialStudio/SerialTransport.h \
+    ../../src/SerialStudio/TcpTransport.h \
+    ../../src/SerialStudio/Transport.h \
+    ../../src/SerialStudio/UdpTransport.h
+
+SOURCES += \
+    main.cpp \
+    ../../src/SerialStudio/LocalTransport.cpp \
+    ../../src/SerialStudio/LoopbackTransport.cpp \
+    ../../src/SerialStudio/SerialTransport.cpp \
+    ../../src/SerialStudio/TcpTransport.cpp \
+    ../../src/SerialStudio/Transport.cpp \
+    ../../src/SerialStudio/UdpTransport.cpp
@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Measures the round-trip latency of a single command through each transport. Every
+ * transport is connected to an echo peer running in this process, a fixed-length
+ * command is written & the clock stops when the echo is received completely.
+ *
+ * On Unix systems, the serial transport is measured through a pseudo-terminal pair,
+ * which compares the serial reader thread with the TCP route to Serial Studio.
+ *
+ * Both ends share the same event loop, so the results are useful to compare the
+ * transports with each other, not as absolute link latencies.
+ */
+
+#include <QTimer>
+#include <QVector>
+#include <QTcpSocket>
+#include <QTcpServer>
+#include <QUdpSocket>
+#include <QTextStream>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QNetworkDatagram>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include <algorithm>
+#include <SerialStudio/Transport.h>
+
+#ifdef Q_OS_UNIX
+#    include <atomic>
+#    include <poll.h>
+#    include <fcntl.h>
+#    include <stdlib.h>
+#    include <unistd.h>
+#    include <QThread>
+#endif
+
+using namespace SerialStudio;
+
+/*
+ * Default number of measured commands per transport
+ */
+#define DEFAULT_COMMANDS 1000
+
+/*
+ * Commands sent before measuring, to let the sockets & caches settle
+ */
+#define WARMUP_COMMANDS 50
+
+/*
+ * Maximum time to wait for a connection or an echo (in milliseconds)
+ */
+#define TIMEOUT 1000
+
+/*
+ * Loopback transports are grouped by port number
+ */
+#define LOOPBACK_PORT 7777
+
+/*
+ * Latency statistics of a single transport
+ */
+struct Result
+{
+    int lost = 0;
+    QVector<qint64> samples;
+};
+
+/**
+ * Runs the event loop until @a done returns @c true, returns @c false if that did not
+ * happen within @c TIMEOUT milliseconds.
+ */
+template<typename Predicate>
+static bool waitFor(Predicate done)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!done())
+    {
+        if (timer.elapsed() > TIMEOUT)
+            return false;
+
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+
+    return true;
+}
+
+/**
+ * Returns a command padded to 22 bytes, like the frames built by the communicator
+ */
+static QByteArray command()
+{
+    QByteArray frame = "CMD,1714,SIM,ENABLE;";
+    while (frame.length() < 22)
+        frame.append('\n');
+
+    return frame;
+}
+
+/**
+ * Connects a transport of the given @a type to @a host and @a port & measures the
+ * round-trip time of @a commands commands.
+ */
+static Result run(const Transport::Type type, const QString &host, const quint16 port,
+                  const int commands)
+{
+    Result result;
+    const auto frame = command();
+
+    // Count echoed bytes
+    int received = 0;
+    QScopedPointer<Transport> transport(Transport::create(type));
+    QObject::connect(transport.data(), &Transport::dataReceived,
+                     [&](const QByteArray &data) { received += data.size(); });
+
+    // Connect to echo peer
+    transport->open(host, port);
+    if (!waitFor([&] { return transport->isConnected(); }))
+    {
+        result.lost = commands;
+        return result;
+    }
+
+    // Send commands one at a time
+    QElapsedTimer timer;
+    result.samples.reserve(commands);
+    for (int i = 0; i < WARMUP_COMMANDS + commands; ++i)
+    {
+        received = 0;
+        timer.start();
+        transport->write(frame);
+        if (!waitFor([&] { return received >= frame.size(); }))
+        {
+            if (i >= WARMUP_COMMANDS)
+                ++result.lost;
+
+            continue;
+        }
+
+        if (i >= WARMUP_COMMANDS)
+            result.samples.append(timer.nsecsElapsed());
+    }
+
+    transport->close();
+    return result;
+}
+
+/**
+ * Returns the given @a percentile of the sorted @a samples in microseconds
+ */
+static double percentile(const QVector<qint64> &samples, const double percentile)
+{
+    if (samples.isEmpty())
+        return 0;
+
+    auto index = static_cast<int>(percentile * (samples.count() - 1));
+    return samples.at(index) / 1000.0;
+}
+
+/**
+ * Prints the statistics of the given @a result
+ */
+static void print(QTextStream &out, const QString &name, Result &result)
+{
+    std::sort(result.samples.begin(), result.samples.end());
+
+    double mean = 0;
+    foreach (auto sample, result.samples)
+        mean += sample / 1000.0;
+    if (!result.samples.isEmpty())
+        mean /= result.samples.count();
+
+    out << QString("%1").arg(name, -10) << QString("%1").arg(result.samples.count(), 9)
+        << QString("%1").arg(result.lost, 7)
+        << QString("%1").arg(percentile(result.samples, 0), 10, 'f', 1)
+        << QString("%1").arg(percentile(result.samples, 0.5), 10, 'f', 1)
+        << QString("%1").arg(percentile(result.samples, 0.99), 10, 'f', 1)
+        << QString("%1").arg(percentile(result.samples, 1), 10, 'f', 1)
+        << QString("%1").arg(mean, 10, 'f', 1) << Qt::endl;
+}
+
+/**
+ * Entry point of the benchmark
+ */
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    // Parse arguments
+    QCommandLineParser parser;
+    QCommandLineOption commandsOption(QStringList() << "n" << "commands",
+                                      "Measured commands per transport.", "count",
+                                      QString::number(DEFAULT_COMMANDS));
+    parser.addHelpOption();
+    parser.addOption(commandsOption);
+    parser.process(app);
+    const auto commands = qMax(1, parser.value(commandsOption).toInt());
+
+    // Wake up the event loop regularly, so that timeouts are detected
+    QTimer heartbeat;
+    heartbeat.start(10);
+
+    // TCP echo peer
+    QTcpServer tcpServer;
+    tcpServer.listen(QHostAddress::LocalHost);
+    QObject::connect(&tcpServer, &QTcpServer::newConnection, [&] {
+        auto socket = tcpServer.nextPendingConnection();
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        QObject::connect(socket, &QTcpSocket::readyRead, [=] {
+            socket->write(socket->readAll());
+            socket->flush();
+        });
+    });
+
+    // UDP echo peer
+    QUdpSocket udpServer;
+    udpServer.bind(QHostAddress::LocalHost);
+    QObject::connect(&udpServer, &QUdpSocket::readyRead, [&] {
+        while (udpServer.hasPendingDatagrams())
+        {
+            auto datagram = udpServer.receiveDatagram();
+            udpServer.writeDatagram(datagram.makeReply(datagram.data()));
+        }
+    });
+
+    // Local socket echo peer
+    const auto localName = QString("cc2021-bench-%1").arg(app.applicationPid());
+    QLocalServer localServer;
+    QLocalServer::removeServer(localName);
+    localServer.listen(localName);
+    QObject::connect(&localServer, &QLocalServer::newConnection, [&] {
+        auto socket = localServer.nextPendingConnection();
+        QObject::connect(socket, &QLocalSocket::readyRead, [=] {
+            socket->write(socket->readAll());
+            socket->flush();
+        });
+    });
+
+    // Loopback echo peer
+    QScopedPointer<Transport> loopback(Transport::create(Transport::Type::Loopback));
+    loopback->open(QString(), LOOPBACK_PORT);
+    QObject::connect(loopback.data(), &Transport::dataReceived,
+                     [&](const QByteArray &data) { loopback->write(data); });
+
+    // Run benchmarks
+    QTextStream out(stdout);
+    out << "Round-trip latency of " << commands << " commands (in microseconds)"
+        << Qt::endl << Qt::endl;
+    out << "Transport  Commands   Lost       Min       p50       p99       Max      Mean"
+        << Qt::endl;
+
+    auto tcp = run(Transport::Type::Tcp, "127.0.0.1", tcpServer.serverPort(), commands);
+    print(out, "TCP", tcp);
+
+    auto udp = run(Transport::Type::Udp, "127.0.0.1", udpServer.localPort(), commands);
+    print(out, "UDP", udp);
+
+    auto local = run(Transport::Type::Local, localName, 0, commands);
+    print(out, "Local", local);
+
+    auto loop = run(Transport::Type::Loopback, QString(), LOOPBACK_PORT, commands);
+    print(out, "Loopback", loop);
+
+#ifdef Q_OS_UNIX
+    // Serial echo peer, the transport opens the slave side of a pseudo-terminal
+    const int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0)
+    {
+        // Echo everything written to the slave side from a separate thread
+        std::atomic<bool> running(true);
+        QScopedPointer<QThread> echo(QThread::create([&] {
+            char buffer[256];
+            pollfd fd = { master, POLLIN, 0 };
+            while (running)
+            {
+                if (poll(&fd, 1, 100) <= 0)
+                    continue;
+
+                const auto bytes = ::read(master, buffer, sizeof(buffer));
+                if (bytes > 0 && ::write(master, buffer, static_cast<size_t>(bytes)) < 0)
+                    break;
+            }
+        }));
+        echo->start();
+
+        const QString slave = ptsname(master);
+        auto serial = run(Transport::Type::Serial, slave, 0, commands);
+        print(out, "Serial", serial);
+
+        running = false;
+        echo->wait();
+    }
+
+    else
+        out << "Serial    (cannot create pseudo-terminal)" << Qt::endl;
+
+    if (master >= 0)
+        ::close(master);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,8 @@
+#-------------------------------------------------------------------------------
+# Benchmarks, build with qmake bench/bench.pro
+#-------------------------------------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    Transports
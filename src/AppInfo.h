@@ -25,6 +25,7 @@
 
 #include <QDir>
 #include <QString>
+#include <QStandardPaths>
 
 // clang-format off
 #define APP_VERSION     "1.0.4"
@@ -35,6 +36,10 @@
 #define APP_UPDATER_URL "https://raw.githubusercontent.com/Kaan-Sat/CC2021-Control-Panel/master/deploy/updates.json"
 #define LOG_FORMAT      "[%{time}] %{message:-72} [%{TypeOne}] [%{function}]\n"
 #define LOG_FILE        QString("%1/%2.log").arg(QDir::tempPath(), APP_NAME)
+#define STARTUP_TRACE_FILE QString("%1/%2 Startup.json").arg(QDir::tempPath(), APP_NAME)
+#define PROFILER_TRACE_FILE QString("%1/%2 Profile.json").arg(QDir::tempPath(), APP_NAME)
+#define FLIGHT_DATA_DIR QString("%1/%2/Flights").arg(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation), APP_NAME)
+#define SESSION_ARCHIVE_DIR QString("%1/%2/Sessions").arg(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation), APP_NAME)
 // clang-format on
 
 #endif
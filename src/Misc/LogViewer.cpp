@@ -0,0 +1,508 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "LogViewer.h"
+
+#include <QtConcurrent>
+#include <QByteArrayMatcher>
+
+#include <AppInfo.h>
+
+#include <cstring>
+
+using namespace Misc;
+
+/*
+ * Number of line offsets sent to the user interface in each batch by the indexer
+ */
+#define INDEX_BATCH_SIZE 65536
+
+/*
+ * Maximum number of lines evaluated by each filter job
+ */
+#define FILTER_BATCH_SIZE 262144
+
+/*
+ * Pointer to singleton instance of class
+ */
+static LogViewer *INSTANCE = nullptr;
+
+/**
+ * Constructor function
+ */
+LogViewer::LogViewer()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_indexing(false)
+    , m_generation(0)
+    , m_abort(false)
+    , m_levels(AllLevels)
+    , m_filteredUpTo(0)
+    , m_filterGeneration(0)
+{
+    connect(&m_filterWatcher, &QFutureWatcher<FilterResult>::finished, this,
+            &LogViewer::onFilterFinished);
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+LogViewer *LogViewer::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new LogViewer;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns the number of lines that are displayed with the current filter
+ */
+int LogViewer::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    if (filterActive())
+        return m_filtered.count();
+
+    return m_offsets.count();
+}
+
+/**
+ * Decodes the line at the given @a index, only the lines that are visible in the user
+ * interface are requested by the view.
+ */
+QVariant LogViewer::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+        return QVariant();
+
+    const int line = filterActive() ? m_filtered.at(index.row()) : index.row();
+    switch (role)
+    {
+        case TextRole:
+        case Qt::DisplayRole:
+            return QString::fromUtf8(lineAt(m_data, m_size, m_offsets, line));
+        case LevelRole:
+            return lineLevel(lineAt(m_data, m_size, m_offsets, line));
+        case LineNumberRole:
+            return line + 1;
+    }
+
+    return QVariant();
+}
+
+/**
+ * Returns the role names used by the QML interface
+ */
+QHash<int, QByteArray> LogViewer::roleNames() const
+{
+    QHash<int, QByteArray> names;
+    names.insert(TextRole, "text");
+    names.insert(LevelRole, "level");
+    names.insert(LineNumberRole, "lineNumber");
+    return names;
+}
+
+/**
+ * Returns @c true while the line index is being built
+ */
+bool LogViewer::indexing() const
+{
+    return m_indexing;
+}
+
+/**
+ * Returns @c true while the filter is being applied to the indexed lines
+ */
+bool LogViewer::filtering() const
+{
+    return filterActive() && m_filteredUpTo < m_offsets.count();
+}
+
+/**
+ * Returns the number of indexed lines of the log file
+ */
+int LogViewer::totalLines() const
+{
+    return m_offsets.count();
+}
+
+/**
+ * Returns the size of the mapped log file in a human-readable format
+ */
+QString LogViewer::fileSize() const
+{
+    return QString("%1 MB").arg(m_size / (1024.0 * 1024.0), 0, 'f', 1);
+}
+
+/**
+ * Returns the text that displayed lines must contain
+ */
+QString LogViewer::filterText() const
+{
+    return QString::fromUtf8(m_filterText);
+}
+
+/**
+ * Returns the mask of log levels that are displayed
+ */
+int LogViewer::levelFilter() const
+{
+    return m_levels;
+}
+
+/**
+ * Maps the log file to memory & starts indexing its lines. Lines written after calling
+ * this function are displayed after opening the file again.
+ */
+void LogViewer::open()
+{
+    // Release current file
+    close();
+
+    // Map log file
+    m_file.setFileName(LOG_FILE);
+    if (!m_file.open(QFile::ReadOnly))
+        return;
+
+    m_size = m_file.size();
+    if (m_size > 0)
+        m_data = m_file.map(0, m_size);
+
+    if (!m_data)
+    {
+        m_size = 0;
+        m_file.close();
+        return;
+    }
+
+    // Index lines in the thread pool
+    m_abort = false;
+    m_indexing = true;
+    const int generation = m_generation;
+    m_indexer = QtConcurrent::run([=] { indexFile(generation); });
+    emit indexingChanged();
+    emit totalLinesChanged();
+}
+
+/**
+ * Stops background jobs, unmaps the log file & clears the model
+ */
+void LogViewer::close()
+{
+    // Stop background jobs before unmapping the file
+    m_abort = true;
+    m_indexer.waitForFinished();
+    m_filterWatcher.waitForFinished();
+
+    // Discard pending batches & filter results
+    ++m_generation;
+    ++m_filterGeneration;
+
+    // Unmap file
+    beginResetModel();
+    if (m_data)
+        m_file.unmap(m_data);
+    if (m_file.isOpen())
+        m_file.close();
+
+    m_size = 0;
+    m_data = nullptr;
+    m_indexing = false;
+    m_filteredUpTo = 0;
+    m_offsets.clear();
+    m_filtered.clear();
+    endResetModel();
+
+    emit indexingChanged();
+    emit filteringChanged();
+    emit totalLinesChanged();
+}
+
+/**
+ * Changes the mask of log @a levels that are displayed
+ */
+void LogViewer::setLevelFilter(const int levels)
+{
+    if (m_levels == levels)
+        return;
+
+    m_levels = levels & AllLevels;
+    ++m_filterGeneration;
+    beginResetModel();
+    m_filtered.clear();
+    m_filteredUpTo = 0;
+    endResetModel();
+
+    emit filterChanged();
+    filterPendingLines();
+}
+
+/**
+ * Changes the @a text that displayed lines must contain (case-sensitive)
+ */
+void LogViewer::setFilterText(const QString &text)
+{
+    const auto utf8 = text.toUtf8();
+    if (m_filterText == utf8)
+        return;
+
+    m_filterText = utf8;
+    ++m_filterGeneration;
+    beginResetModel();
+    m_filtered.clear();
+    m_filteredUpTo = 0;
+    endResetModel();
+
+    emit filterChanged();
+    filterPendingLines();
+}
+
+/**
+ * Appends the lines that matched the filter to the model & continues filtering the
+ * rest of the index
+ */
+void LogViewer::onFilterFinished()
+{
+    // Filter changed while the job was running, start again
+    const auto result = m_filterWatcher.result();
+    if (result.generation != m_filterGeneration || !filterActive())
+    {
+        filterPendingLines();
+        return;
+    }
+
+    // Add matching lines
+    if (!result.lines.isEmpty())
+    {
+        beginInsertRows(QModelIndex(), m_filtered.count(),
+                        m_filtered.count() + result.lines.count() - 1);
+        m_filtered += result.lines;
+        endInsertRows();
+    }
+
+    // Filter next batch
+    m_filteredUpTo = result.last;
+    filterPendingLines();
+}
+
+/**
+ * Returns @c true if a level or text filter is set
+ */
+bool LogViewer::filterActive() const
+{
+    return m_levels != AllLevels || !m_filterText.isEmpty();
+}
+
+/**
+ * Starts a background job that filters the next batch of indexed lines, only one job
+ * runs at a time so that results are always appended in order.
+ */
+void LogViewer::filterPendingLines()
+{
+    emit filteringChanged();
+
+    if (!filterActive() || m_filterWatcher.isRunning())
+        return;
+
+    if (m_filteredUpTo >= m_offsets.count())
+        return;
+
+    // Copy the offsets of the batch (& the start of the next line)
+    const int first = m_filteredUpTo;
+    const int count = qMin(FILTER_BATCH_SIZE, m_offsets.count() - first);
+    const auto offsets = m_offsets.mid(first, count + 1);
+
+    // Start job
+    const auto data = m_data;
+    const auto size = m_size;
+    const auto text = m_filterText;
+    const auto levels = m_levels;
+    const auto generation = m_filterGeneration;
+    const auto abort = &m_abort;
+    m_filterWatcher.setFuture(QtConcurrent::run([=] {
+        return filterLines(data, size, offsets, first, count, generation, text, levels,
+                           abort);
+    }));
+}
+
+/**
+ * Adds a batch of line @a offsets generated by the indexer to the model
+ */
+void LogViewer::appendLines(const int generation, const QVector<qint64> &offsets)
+{
+    // Batch belongs to a previous file
+    if (generation != m_generation)
+        return;
+
+    // Add lines, the model only changes if no filter is set
+    if (!offsets.isEmpty())
+    {
+        if (!filterActive())
+            beginInsertRows(QModelIndex(), m_offsets.count(),
+                            m_offsets.count() + offsets.count() - 1);
+
+        m_offsets += offsets;
+
+        if (!filterActive())
+            endInsertRows();
+
+        emit totalLinesChanged();
+    }
+
+    // Filter new lines
+    filterPendingLines();
+}
+
+/**
+ * Scans the mapped file for line feeds & sends the offsets of the lines to the user
+ * interface thread in batches. Runs in the thread pool.
+ */
+void LogViewer::indexFile(const int generation)
+{
+    QVector<qint64> batch;
+    batch.reserve(INDEX_BATCH_SIZE);
+
+    // clang-format off
+    auto send = [&] {
+        const auto offsets = batch;
+        QMetaObject::invokeMethod(this, [=] { appendLines(generation, offsets); },
+                                  Qt::QueuedConnection);
+        batch.clear();
+        batch.reserve(INDEX_BATCH_SIZE);
+    };
+    // clang-format on
+
+    // Find line starts
+    qint64 start = 0;
+    const auto data = m_data;
+    const auto size = m_size;
+    while (start < size && !m_abort)
+    {
+        batch.append(start);
+        if (batch.count() >= INDEX_BATCH_SIZE)
+            send();
+
+        auto end = static_cast<const uchar *>(
+            std::memchr(data + start, '\n', size - start));
+        if (!end)
+            break;
+
+        start = end - data + 1;
+    }
+
+    // Send last batch & notify the user interface
+    send();
+    // clang-format off
+    QMetaObject::invokeMethod(this, [=] {
+        if (generation == m_generation) {
+            m_indexing = false;
+            emit indexingChanged();
+        }
+    }, Qt::QueuedConnection);
+    // clang-format on
+}
+
+/**
+ * Returns the level of the given log @a line, obtained from the [%{TypeOne}] field of
+ * the log format.
+ */
+int LogViewer::lineLevel(const QByteArray &line)
+{
+    int index = line.indexOf(" [");
+    while (index >= 0 && index + 3 < line.size())
+    {
+        if (line.at(index + 3) == ']')
+        {
+            switch (line.at(index + 2))
+            {
+                case 'T':
+                case 'D':
+                    return Debug;
+                case 'I':
+                    return Info;
+                case 'W':
+                    return Warning;
+                case 'E':
+                case 'F':
+                    return Error;
+            }
+        }
+
+        index = line.indexOf(" [", index + 1);
+    }
+
+    return Info;
+}
+
+/**
+ * Returns the line at the given @a index of the @a offsets vector without copying its
+ * contents, line terminators are removed.
+ */
+QByteArray LogViewer::lineAt(const uchar *data, const qint64 size,
+                             const QVector<qint64> &offsets, const int index)
+{
+    if (!data || index < 0 || index >= offsets.count())
+        return QByteArray();
+
+    const auto start = offsets.at(index);
+    auto end = index + 1 < offsets.count() ? offsets.at(index + 1) : size;
+    while (end > start && (data[end - 1] == '\n' || data[end - 1] == '\r'))
+        --end;
+
+    const auto chars = reinterpret_cast<const char *>(data + start);
+    return QByteArray::fromRawData(chars, static_cast<int>(end - start));
+}
+
+/**
+ * Returns the indexes of the lines that match the given @a text & @a levels. The
+ * @a offsets vector contains the batch of lines that begins at line @a first. Runs in
+ * the thread pool.
+ */
+LogViewer::FilterResult LogViewer::filterLines(const uchar *data, const qint64 size,
+                                               const QVector<qint64> &offsets,
+                                               const int first, const int count,
+                                               const int generation,
+                                               const QByteArray &text, const int levels,
+                                               const std::atomic<bool> *abort)
+{
+    FilterResult result;
+    result.generation = generation;
+    result.last = first + count;
+
+    const QByteArrayMatcher matcher(text);
+    for (int i = 0; i < count && !*abort; ++i)
+    {
+        const auto line = lineAt(data, size, offsets, i);
+        if (!(lineLevel(line) & levels))
+            continue;
+
+        if (!text.isEmpty() && matcher.indexIn(line) < 0)
+            continue;
+
+        result.lines.append(first + i);
+    }
+
+    return result;
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISC_LOG_VIEWER_H
+#define MISC_LOG_VIEWER_H
+
+#include <QFile>
+#include <QVector>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QAbstractListModel>
+
+#include <atomic>
+
+namespace Misc
+{
+/**
+ * Virtualized model of the application log file. The file is memory-mapped & a
+ * background thread builds an index with the offset of each line, lines are only
+ * decoded when the view requests them.
+ *
+ * Level & text filters are also evaluated in a background thread, the model shows the
+ * matching lines as soon as each batch of the index is filtered.
+ */
+class LogViewer : public QAbstractListModel
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool indexing
+               READ indexing
+               NOTIFY indexingChanged)
+    Q_PROPERTY(bool filtering
+               READ filtering
+               NOTIFY filteringChanged)
+    Q_PROPERTY(int totalLines
+               READ totalLines
+               NOTIFY totalLinesChanged)
+    Q_PROPERTY(QString fileSize
+               READ fileSize
+               NOTIFY totalLinesChanged)
+    Q_PROPERTY(QString filterText
+               READ filterText
+               WRITE setFilterText
+               NOTIFY filterChanged)
+    Q_PROPERTY(int levelFilter
+               READ levelFilter
+               WRITE setLevelFilter
+               NOTIFY filterChanged)
+    // clang-format on
+
+signals:
+    void filterChanged();
+    void indexingChanged();
+    void filteringChanged();
+    void totalLinesChanged();
+
+public:
+    enum Level
+    {
+        Debug = 0x01,
+        Info = 0x02,
+        Warning = 0x04,
+        Error = 0x08,
+        AllLevels = 0x0F,
+    };
+    Q_ENUM(Level)
+
+    enum Roles
+    {
+        TextRole = Qt::UserRole + 1,
+        LevelRole,
+        LineNumberRole,
+    };
+
+    static LogViewer *getInstance();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    bool indexing() const;
+    bool filtering() const;
+    int totalLines() const;
+    QString fileSize() const;
+    QString filterText() const;
+    int levelFilter() const;
+
+public slots:
+    void open();
+    void close();
+    void setLevelFilter(const int levels);
+    void setFilterText(const QString &text);
+
+private slots:
+    void onFilterFinished();
+
+private:
+    LogViewer();
+
+    struct FilterResult
+    {
+        int generation;
+        int last;
+        QVector<int> lines;
+    };
+
+    bool filterActive() const;
+    void filterPendingLines();
+    void appendLines(const int generation, const QVector<qint64> &offsets);
+    void indexFile(const int generation);
+
+    static int lineLevel(const QByteArray &line);
+    static QByteArray lineAt(const uchar *data, const qint64 size,
+                             const QVector<qint64> &offsets, const int index);
+    static FilterResult filterLines(const uchar *data, const qint64 size,
+                                    const QVector<qint64> &offsets, const int first,
+                                    const int count, const int generation,
+                                    const QByteArray &text, const int levels,
+                                    const std::atomic<bool> *abort);
+
+private:
+    QFile m_file;
+    uchar *m_data;
+    qint64 m_size;
+
+    bool m_indexing;
+    int m_generation;
+    std::atomic<bool> m_abort;
+    QFuture<void> m_indexer;
+    QVector<qint64> m_offsets;
+
+    int m_levels;
+    int m_filteredUpTo;
+    int m_filterGeneration;
+    QByteArray m_filterText;
+    QVector<int> m_filtered;
+    QFutureWatcher<FilterResult> m_filterWatcher;
+};
+}
+
+#endif
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Metrics.h"
+#include "TimerEvents.h"
+#include "MetricsServer.h"
+
+#include <atomic>
+
+#include <QSettings>
+#include <QApplication>
+
+using namespace Misc;
+
+/*
+ * Default TCP port of the metrics endpoint, set it to 0 in the settings to disable it
+ */
+#define DEFAULT_METRICS_PORT 9101
+
+/*
+ * Metric values, updated without locks from any thread
+ */
+static std::atomic<qint64> VALUES[Metrics::MetricCount];
+
+/*
+ * Prometheus metadata of each metric, in the same order as the @c Metric enum. Values
+ * are divided by the scale factor when they are exported (e.g. us to seconds).
+ */
+struct MetricInfo
+{
+    const char *name;
+    const char *type;
+    const char *help;
+    double scale;
+};
+
+// clang-format off
+static const MetricInfo METRIC_INFO[Metrics::MetricCount] = {
+    {"cc2021_frames_sent_total",               "counter", "Frames written to the Serial Studio links",            1},
+    {"cc2021_bytes_sent_total",                "counter", "Bytes written to the Serial Studio links",             1},
+    {"cc2021_frames_dropped_total",            "counter", "Frames discarded by the link send queues",             1},
+    {"cc2021_reconnects_total",                "counter", "Times that a Serial Studio link was re-established",   1},
+    {"cc2021_queue_depth",                     "gauge",   "Frames waiting in the link send queues",               1},
+    {"cc2021_simulation_row",                  "gauge",   "Current row of the pressure simulation profile",       1},
+    {"cc2021_simulation_tick_jitter_seconds",  "gauge",   "Deviation of the last simulation tick from 1 s",       1e6},
+    {"cc2021_simulation_tick_jitter_max_seconds", "gauge", "Maximum deviation of a simulation tick from 1 s",     1e6},
+    {"cc2021_telemetry_packets_total",         "counter", "Telemetry packets received (without duplicates)",      1},
+    {"cc2021_telemetry_rate",                  "gauge",   "Telemetry packets received during the last second",    1},
+    {"cc2021_duplicate_packets_total",         "counter", "Telemetry packets received through more than one link", 1},
+    {"cc2021_pending_commands",                "gauge",   "Commands waiting for an acknowledgement",              1},
+    {"cc2021_event_loop_latency_max_seconds",  "gauge",   "Maximum time that a heartbeat waited in the event loop", 1e6},
+    {"cc2021_event_loop_stalls_total",         "counter", "Times that the event loop was blocked over the threshold", 1},
+};
+// clang-format on
+
+/**
+ * Pointer to the only instance of the class
+ */
+static Metrics *INSTANCE = nullptr;
+
+/**
+ * Constructor function, starts the metrics server in its own thread
+ */
+Metrics::Metrics()
+    : m_lastPackets(0)
+    , m_server(nullptr)
+{
+    // Get port number
+    auto port = QSettings().value("Metrics/port", DEFAULT_METRICS_PORT).toUInt();
+    m_port = static_cast<quint16>(qMin<uint>(port, 0xFFFF));
+
+    // Start server thread
+    if (m_port > 0)
+    {
+        m_server = new MetricsServer(m_port);
+        m_server->moveToThread(&m_thread);
+        connect(&m_thread, &QThread::started, m_server, &MetricsServer::start);
+        connect(&m_thread, &QThread::finished, m_server, &MetricsServer::deleteLater);
+        m_thread.setObjectName("Metrics server");
+        m_thread.start(QThread::LowPriority);
+    }
+
+    // Update rate gauges & stop the server thread before exiting
+    auto te = TimerEvents::getInstance();
+    connect(te, &TimerEvents::timeout1Hz, this, &Metrics::updateRates);
+    connect(qApp, &QApplication::aboutToQuit, this, &Metrics::stop);
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+Metrics *Metrics::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new Metrics;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns the current value of the given @a metric
+ */
+qint64 Metrics::value(const Metric metric)
+{
+    return VALUES[metric].load(std::memory_order_relaxed);
+}
+
+/**
+ * Changes the value of the given gauge @a metric
+ */
+void Metrics::set(const Metric metric, const qint64 value)
+{
+    VALUES[metric].store(value, std::memory_order_relaxed);
+}
+
+/**
+ * Adds the given @a value to the given @a metric
+ */
+void Metrics::increment(const Metric metric, const qint64 value)
+{
+    VALUES[metric].fetch_add(value, std::memory_order_relaxed);
+}
+
+/**
+ * Changes the value of the given @a metric only if the new @a value is greater
+ */
+void Metrics::updateMaximum(const Metric metric, const qint64 value)
+{
+    auto current = VALUES[metric].load(std::memory_order_relaxed);
+    while (value > current
+           && !VALUES[metric].compare_exchange_weak(current, value,
+                                                    std::memory_order_relaxed))
+    {
+    }
+}
+
+/**
+ * Returns all the metrics in the Prometheus text exposition format
+ */
+QByteArray Metrics::exposition()
+{
+    QByteArray text;
+    text.reserve(MetricCount * 160);
+    for (int i = 0; i < MetricCount; ++i)
+    {
+        const auto &info = METRIC_INFO[i];
+        const auto value = VALUES[i].load(std::memory_order_relaxed);
+
+        text.append("# HELP ").append(info.name).append(' ').append(info.help);
+        text.append("\n# TYPE ").append(info.name).append(' ').append(info.type);
+        text.append('\n').append(info.name).append(' ');
+        if (info.scale == 1)
+            text.append(QByteArray::number(value));
+        else
+            text.append(QByteArray::number(value / info.scale, 'g', 9));
+
+        text.append('\n');
+    }
+
+    return text;
+}
+
+/**
+ * Returns the URL of the metrics endpoint
+ */
+QString Metrics::endpoint() const
+{
+    if (m_port == 0)
+        return tr("Disabled");
+
+    return QString("http://127.0.0.1:%1/metrics").arg(m_port);
+}
+
+/**
+ * Stops the server thread
+ */
+void Metrics::stop()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+/**
+ * Calculates the gauges that depend on counter differences
+ */
+void Metrics::updateRates()
+{
+    const auto packets = value(TelemetryPackets);
+    set(TelemetryRate, packets - m_lastPackets);
+    m_lastPackets = packets;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISC_METRICS_H
+#define MISC_METRICS_H
+
+#include <QThread>
+#include <QObject>
+#include <QByteArray>
+
+namespace Misc
+{
+class MetricsServer;
+
+/**
+ * Counters & gauges that describe the state of the communication modules. Values are
+ * stored in atomic variables, so they can be updated from the hot paths without locks
+ * and read by the metrics server thread at any time.
+ *
+ * The values are exposed in the Prometheus text format through a local HTTP endpoint
+ * (http://127.0.0.1:9101/metrics by default).
+ */
+class Metrics : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(QString endpoint
+               READ endpoint
+               CONSTANT)
+    // clang-format on
+
+public:
+    enum Metric
+    {
+        FramesSent,
+        BytesSent,
+        FramesDropped,
+        Reconnects,
+        QueueDepth,
+        SimulationRow,
+        SimulationTickJitter,
+        SimulationTickJitterMax,
+        TelemetryPackets,
+        TelemetryRate,
+        DuplicatePackets,
+        PendingCommands,
+        EventLoopLatencyMax,
+        EventLoopStalls,
+        MetricCount,
+    };
+
+    static Metrics *getInstance();
+
+    static qint64 value(const Metric metric);
+    static void set(const Metric metric, const qint64 value);
+    static void increment(const Metric metric, const qint64 value = 1);
+    static void updateMaximum(const Metric metric, const qint64 value);
+
+    static QByteArray exposition();
+
+    QString endpoint() const;
+
+private slots:
+    void stop();
+    void updateRates();
+
+private:
+    Metrics();
+
+private:
+    quint16 m_port;
+    QThread m_thread;
+    qint64 m_lastPackets;
+    MetricsServer *m_server;
+};
+}
+
+#endif
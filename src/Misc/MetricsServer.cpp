@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Metrics.h"
+#include "MetricsServer.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <Logger.h>
+
+using namespace Misc;
+
+/*
+ * Maximum size of an HTTP request header
+ */
+#define MAX_REQUEST_SIZE 8192
+
+/**
+ * Constructor function, the server is created by @c start() in the server thread
+ */
+MetricsServer::MetricsServer(const quint16 port)
+    : m_port(port)
+    , m_server(nullptr)
+{
+}
+
+/**
+ * Starts listening for connections on the loopback interface
+ */
+void MetricsServer::start()
+{
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+
+    if (m_server->listen(QHostAddress::LocalHost, m_port))
+        LOG_INFO() << "Metrics endpoint listening on port" << m_port;
+    else
+        LOG_WARNING() << "Cannot start metrics endpoint" << m_server->errorString();
+}
+
+/**
+ * Reads the request of each new client, sends the response & closes the connection
+ */
+void MetricsServer::onNewConnection()
+{
+    while (m_server->hasPendingConnections())
+    {
+        auto socket = m_server->nextPendingConnection();
+        connect(socket, &QTcpSocket::disconnected, socket, &QTcpSocket::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, socket, [socket]() {
+            // Wait until we receive the complete request header
+            if (!socket->peek(MAX_REQUEST_SIZE).contains("\r\n\r\n")
+                && socket->bytesAvailable() < MAX_REQUEST_SIZE)
+                return;
+
+            // Generate response
+            QByteArray status = "200 OK";
+            QByteArray body;
+            auto request = socket->readAll();
+            if (request.startsWith("GET /metrics ") || request.startsWith("GET / "))
+                body = Metrics::exposition();
+            else
+            {
+                status = "404 Not Found";
+                body = "Not found\n";
+            }
+
+            // Send response & close connection
+            QByteArray response;
+            response.append("HTTP/1.1 ").append(status).append("\r\n");
+            response.append("Content-Type: text/plain; version=0.0.4\r\n");
+            response.append("Content-Length: ").append(QByteArray::number(body.size()));
+            response.append("\r\nConnection: close\r\n\r\n");
+            response.append(body);
+            socket->write(response);
+            socket->disconnectFromHost();
+        });
+    }
+}
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Profiler.h"
+
+#ifdef CC2021_PROFILER
+#    include <QFile>
+#    include <QMutex>
+#    include <QThread>
+#    include <QVector>
+#    include <QTextStream>
+#    include <QCoreApplication>
+
+#    include <new>
+#    include <chrono>
+#    include <cstdlib>
+#endif
+
+using namespace Misc;
+
+/**
+ * Returns @c true if the application was built with the profiler enabled
+ */
+bool Profiler::enabled()
+{
+#ifdef CC2021_PROFILER
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef CC2021_PROFILER
+
+/*
+ * Number of events stored for each thread, older events are overwritten
+ */
+#    define BUFFER_CAPACITY 65536
+
+/*
+ * Event recorded by a profiler zone
+ */
+struct Event
+{
+    const char *name;
+    qint64 start;
+    qint64 duration;
+    quint64 allocations;
+    quint64 allocatedBytes;
+};
+
+/*
+ * Ring buffer with the events of a single thread, the mutex is only contended while
+ * the trace is being exported
+ */
+struct ThreadBuffer
+{
+    int id;
+    QString name;
+    QMutex mutex;
+    quint64 count;
+    Event events[BUFFER_CAPACITY];
+};
+
+/*
+ * Allocation counters of the current thread, they are plain integers so that they can
+ * be used by operator new without allocating memory
+ */
+static thread_local quint64 ALLOCATIONS = 0;
+static thread_local quint64 ALLOCATED_BYTES = 0;
+
+/*
+ * Event buffer of the current thread & list of all buffers
+ */
+static thread_local ThreadBuffer *THREAD_BUFFER = nullptr;
+static QMutex REGISTRY_MUTEX;
+static QVector<ThreadBuffer *> BUFFERS;
+
+/*
+ * Reference time of the trace
+ */
+static const auto EPOCH = std::chrono::steady_clock::now();
+
+/**
+ * Returns the number of nanoseconds since the application started
+ */
+static qint64 now()
+{
+    const auto elapsed = std::chrono::steady_clock::now() - EPOCH;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+/**
+ * Returns the event buffer of the current thread, the buffer is created & registered
+ * the first time that the thread records a zone
+ */
+static ThreadBuffer *threadBuffer()
+{
+    if (!THREAD_BUFFER)
+    {
+        auto buffer = new ThreadBuffer;
+        buffer->count = 0;
+
+        auto thread = QThread::currentThread();
+        auto app = QCoreApplication::instance();
+        if (app && thread == app->thread())
+            buffer->name = "Main thread";
+        else
+            buffer->name = thread->objectName();
+
+        QMutexLocker locker(&REGISTRY_MUTEX);
+        buffer->id = BUFFERS.count() + 1;
+        if (buffer->name.isEmpty())
+            buffer->name = QString("Thread %1").arg(buffer->id);
+
+        BUFFERS.append(buffer);
+        THREAD_BUFFER = buffer;
+    }
+
+    return THREAD_BUFFER;
+}
+
+/**
+ * Starts recording a zone
+ */
+ProfileZone::ProfileZone(const char *name)
+    : m_name(name)
+    , m_start(now())
+    , m_allocations(ALLOCATIONS)
+    , m_allocatedBytes(ALLOCATED_BYTES)
+{
+}
+
+/**
+ * Stores the duration & allocations of the zone in the buffer of the current thread
+ */
+ProfileZone::~ProfileZone()
+{
+    const auto end = now();
+    const auto allocations = ALLOCATIONS - m_allocations;
+    const auto allocatedBytes = ALLOCATED_BYTES - m_allocatedBytes;
+
+    auto buffer = threadBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    auto &event = buffer->events[buffer->count % BUFFER_CAPACITY];
+    event.name = m_name;
+    event.start = m_start;
+    event.duration = end - m_start;
+    event.allocations = allocations;
+    event.allocatedBytes = allocatedBytes;
+    ++buffer->count;
+}
+
+/**
+ * Writes the events of all threads to the given @a path in the Chrome trace format
+ */
+bool Profiler::exportTrace(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    bool first = true;
+    QMutexLocker registryLocker(&REGISTRY_MUTEX);
+    foreach (auto buffer, BUFFERS)
+    {
+        QMutexLocker locker(&buffer->mutex);
+
+        // Thread name
+        out << (first ? "\n" : ",\n");
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+            << ",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+        first = false;
+
+        // Events, from oldest to newest
+        const quint64 count = qMin<quint64>(buffer->count, BUFFER_CAPACITY);
+        for (quint64 i = buffer->count - count; i < buffer->count; ++i)
+        {
+            const auto &event = buffer->events[i % BUFFER_CAPACITY];
+            out << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1"
+                << ",\"tid\":" << buffer->id
+                << ",\"ts\":" << QString::number(event.start / 1000.0, 'f', 3)
+                << ",\"dur\":" << QString::number(event.duration / 1000.0, 'f', 3)
+                << ",\"args\":{\"allocations\":" << event.allocations
+                << ",\"bytes\":" << event.allocatedBytes << "}}";
+        }
+    }
+
+    out << "\n]}\n";
+    out.flush();
+    return file.error() == QFile::NoError;
+}
+
+/*
+ * Replacements of the global allocation functions, they count the allocations of the
+ * current thread & forward the request to malloc()
+ */
+void *operator new(std::size_t size)
+{
+    ++ALLOCATIONS;
+    ALLOCATED_BYTES += size;
+
+    if (auto ptr = std::malloc(size ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#else
+
+/**
+ * The profiler is disabled, there is nothing to export
+ */
+bool Profiler::exportTrace(const QString &path)
+{
+    Q_UNUSED(path);
+    return false;
+}
+
+#endif
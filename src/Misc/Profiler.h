@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISC_PROFILER_H
+#define MISC_PROFILER_H
+
+#include <QString>
+
+/*
+ * Scoped zone markers, they only generate code when the application is built with the
+ * profiler enabled (qmake CONFIG+=profiler)
+ */
+#ifdef CC2021_PROFILER
+#    define PROFILE_ZONE_CONCAT_(a, b) a##b
+#    define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_(a, b)
+#    define PROFILE_ZONE(name) \
+        Misc::ProfileZone PROFILE_ZONE_CONCAT(profileZone, __LINE__)(name)
+#else
+#    define PROFILE_ZONE(name)
+#endif
+
+namespace Misc
+{
+/**
+ * Instrumentation profiler for the hot paths of the application.
+ *
+ * Each zone records its duration & the number of heap allocations (counted through
+ * replacements of the global operator new) performed while the zone was active. Events
+ * are stored in a fixed-size buffer for each thread, so recording a zone does not
+ * contend with other threads. The recorded events can be exported in the Chrome trace
+ * format & opened with chrome://tracing or Perfetto.
+ *
+ * When the profiler is disabled, zones compile to nothing & no functions of this class
+ * are used.
+ */
+class Profiler
+{
+public:
+    static bool enabled();
+    static bool exportTrace(const QString &path);
+};
+
+#ifdef CC2021_PROFILER
+/**
+ * Records a profiler event from its construction until it goes out of scope. The
+ * @a name must be a string literal (only the pointer is stored).
+ */
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char *name);
+    ~ProfileZone();
+
+private:
+    const char *m_name;
+    qint64 m_start;
+    quint64 m_allocations;
+    quint64 m_allocatedBytes;
+};
+#endif
+}
+
+#endif
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "RenderStats.h"
+#include "TimerEvents.h"
+
+#include <QQuickWindow>
+
+#ifdef Q_OS_WIN
+#    include <windows.h>
+#else
+#    include <sys/time.h>
+#    include <sys/resource.h>
+#endif
+
+using namespace Misc;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static RenderStats *INSTANCE = nullptr;
+
+/**
+ * Constructor function
+ */
+RenderStats::RenderStats()
+    : m_framesPerSecond(0)
+    , m_frameTime(0)
+    , m_cpuUsage(0)
+    , m_frames(0)
+    , m_renderTime(0)
+{
+    m_wallClock.start();
+    m_lastCpuTime = processCpuTime();
+
+    auto te = TimerEvents::getInstance();
+    connect(te, &TimerEvents::timeout1Hz, this, &RenderStats::update);
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+RenderStats *RenderStats::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new RenderStats;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns the number of frames rendered during the last second
+ */
+int RenderStats::framesPerSecond() const
+{
+    return m_framesPerSecond;
+}
+
+/**
+ * Returns the average time (in ms) spent rendering a frame during the last second
+ */
+double RenderStats::frameTime() const
+{
+    return m_frameTime;
+}
+
+/**
+ * Returns the CPU usage (in percent of a single core) of the application during the
+ * last second
+ */
+double RenderStats::cpuUsage() const
+{
+    return m_cpuUsage;
+}
+
+/**
+ * Starts measuring the frames rendered by the given @a window. The rendering signals are
+ * emitted by the render thread, so they are handled with direct connections & atomic
+ * counters.
+ */
+void RenderStats::attach(QQuickWindow *window)
+{
+    if (!window)
+        return;
+
+    connect(window, &QQuickWindow::beforeRendering, this,
+            &RenderStats::onBeforeRendering, Qt::DirectConnection);
+    connect(window, &QQuickWindow::afterRendering, this, &RenderStats::onAfterRendering,
+            Qt::DirectConnection);
+    connect(window, &QQuickWindow::frameSwapped, this, &RenderStats::onFrameSwapped,
+            Qt::DirectConnection);
+}
+
+/**
+ * Returns the CPU time (in microseconds) used by all the threads of the process
+ */
+qint64 RenderStats::processCpuTime()
+{
+#ifdef Q_OS_WIN
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return 0;
+
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return static_cast<qint64>((k.QuadPart + u.QuadPart) / 10);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+    return static_cast<qint64>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000
+           + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+/**
+ * Calculates the statistics of the last second & updates the user interface if any of
+ * them changed
+ */
+void RenderStats::update()
+{
+    // Get frame counters
+    const int frames = m_frames.exchange(0);
+    const qint64 renderTime = m_renderTime.exchange(0);
+
+    // Get CPU usage
+    const qint64 cpuTime = processCpuTime();
+    const qint64 wallTime = qMax<qint64>(1, m_wallClock.nsecsElapsed() / 1000);
+    const double cpuUsage = 100.0 * (cpuTime - m_lastCpuTime) / wallTime;
+    m_lastCpuTime = cpuTime;
+    m_wallClock.restart();
+
+    // Get average frame time
+    double frameTime = 0;
+    if (frames > 0)
+        frameTime = renderTime / 1e6 / frames;
+
+    // Update UI only if needed
+    if (frames != m_framesPerSecond || qAbs(frameTime - m_frameTime) >= 0.05
+        || qAbs(cpuUsage - m_cpuUsage) >= 0.5)
+    {
+        m_frameTime = frameTime;
+        m_cpuUsage = cpuUsage;
+        m_framesPerSecond = frames;
+        emit statisticsChanged();
+    }
+}
+
+/**
+ * Starts measuring the render time of the current frame (render thread)
+ */
+void RenderStats::onBeforeRendering()
+{
+    m_renderClock.start();
+}
+
+/**
+ * Registers the render time of the current frame (render thread)
+ */
+void RenderStats::onAfterRendering()
+{
+    m_renderTime += m_renderClock.nsecsElapsed();
+}
+
+/**
+ * Registers a new frame (render thread)
+ */
+void RenderStats::onFrameSwapped()
+{
+    ++m_frames;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISC_RENDER_STATS_H
+#define MISC_RENDER_STATS_H
+
+#include <atomic>
+
+#include <QObject>
+#include <QElapsedTimer>
+
+class QQuickWindow;
+
+namespace Misc
+{
+/**
+ * Measures the number of frames rendered per second, the average time spent rendering
+ * each frame & the CPU usage of the application. This allows us to verify that the
+ * user interface does not repaint when nothing changes.
+ */
+class RenderStats : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int framesPerSecond
+               READ framesPerSecond
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(double frameTime
+               READ frameTime
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(double cpuUsage
+               READ cpuUsage
+               NOTIFY statisticsChanged)
+    // clang-format on
+
+signals:
+    void statisticsChanged();
+
+public:
+    static RenderStats *getInstance();
+
+    int framesPerSecond() const;
+    double frameTime() const;
+    double cpuUsage() const;
+
+    void attach(QQuickWindow *window);
+    static qint64 processCpuTime();
+
+private slots:
+    void update();
+    void onBeforeRendering();
+    void onAfterRendering();
+    void onFrameSwapped();
+
+private:
+    RenderStats();
+
+private:
+    int m_framesPerSecond;
+    double m_frameTime;
+    double m_cpuUsage;
+
+    qint64 m_lastCpuTime;
+    QElapsedTimer m_wallClock;
+    QElapsedTimer m_renderClock;
+
+    std::atomic<int> m_frames;
+    std::atomic<qint64> m_renderTime;
+};
+}
+
+#endif
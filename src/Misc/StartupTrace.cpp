@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "StartupTrace.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#include <Logger.h>
+#include <AppInfo.h>
+
+using namespace Misc;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static StartupTrace *INSTANCE = nullptr;
+
+/**
+ * Constructor function, starts the startup timer
+ */
+StartupTrace::StartupTrace()
+    : m_finished(false)
+    , m_loggerReady(false)
+{
+    m_timer.start();
+}
+
+/**
+ * Returns a pointer to the only instance of the class, this should be called as soon as
+ * possible in the @c main() function.
+ */
+StartupTrace *StartupTrace::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new StartupTrace;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns the number of milliseconds elapsed since the application started
+ */
+qint64 StartupTrace::elapsed() const
+{
+    return m_timer.elapsed();
+}
+
+/**
+ * Writes the registered phases to a JSON file in the temp. directory & returns the
+ * path of the file.
+ */
+QString StartupTrace::exportTrace() const
+{
+    // Create phase list
+    QJsonArray phases;
+    qint64 previous = 0;
+    foreach (const auto &phase, m_phases)
+    {
+        QJsonObject object;
+        object.insert("name", phase.name);
+        object.insert("ms", phase.nsecs / 1e6);
+        object.insert("delta_ms", (phase.nsecs - previous) / 1e6);
+        phases.append(object);
+        previous = phase.nsecs;
+    }
+
+    // Create document
+    QJsonObject root;
+    root.insert("application", APP_NAME);
+    root.insert("version", APP_VERSION);
+    root.insert("phases", phases);
+
+    // Write file
+    QFile file(STARTUP_TRACE_FILE);
+    if (file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+        file.close();
+        return file.fileName();
+    }
+
+    LOG_WARNING() << "Cannot write startup trace" << file.errorString();
+    return "";
+}
+
+/**
+ * Stops registering phases & exports the startup trace
+ */
+void StartupTrace::finish()
+{
+    if (!m_finished)
+    {
+        mark("Startup finished");
+        m_finished = true;
+        LOG_INFO() << "Startup trace saved to" << exportTrace();
+    }
+}
+
+/**
+ * Writes the phases that were registered before the log appenders existed to the log,
+ * later phases are written as they happen.
+ */
+void StartupTrace::setLoggerReady()
+{
+    if (!m_loggerReady)
+    {
+        m_loggerReady = true;
+        foreach (const auto &phase, m_phases)
+            log(phase.name, phase.nsecs);
+    }
+}
+
+/**
+ * Registers the given startup @a phase with the current time
+ */
+void StartupTrace::mark(const QString &phase)
+{
+    if (m_finished)
+        return;
+
+    Phase p;
+    p.name = phase;
+    p.nsecs = m_timer.nsecsElapsed();
+    m_phases.append(p);
+
+    if (m_loggerReady)
+        log(p.name, p.nsecs);
+}
+
+/**
+ * Writes the given phase @a name & time (in nanoseconds) to the log
+ */
+void StartupTrace::log(const QString &name, const qint64 nsecs)
+{
+    LOG_INFO() << "Startup phase" << name << "reached at" << nsecs / 1000000 << "ms";
+}
+
+/**
+ * Registers the given startup @a phase only if it was not registered before
+ */
+void StartupTrace::markOnce(const QString &phase)
+{
+    foreach (const auto &p, m_phases)
+    {
+        if (p.name == phase)
+            return;
+    }
+
+    mark(phase);
+}
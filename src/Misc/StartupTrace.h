@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISC_STARTUP_TRACE_H
+#define MISC_STARTUP_TRACE_H
+
+#include <QVector>
+#include <QObject>
+#include <QElapsedTimer>
+
+namespace Misc
+{
+/**
+ * Records the time at which each startup phase of the application is reached, so that
+ * we can find out what delays the first frame & the first connection with Serial
+ * Studio. Phases are written to the log as they happen & can be exported to a JSON file.
+ *
+ * Phases that are reached before the log appenders are registered are kept in memory &
+ * written to the log when @c setLoggerReady() is called.
+ */
+class StartupTrace : public QObject
+{
+    Q_OBJECT
+
+public:
+    static StartupTrace *getInstance();
+
+    qint64 elapsed() const;
+    Q_INVOKABLE QString exportTrace() const;
+
+public slots:
+    void finish();
+    void setLoggerReady();
+    void mark(const QString &phase);
+    void markOnce(const QString &phase);
+
+private:
+    StartupTrace();
+    void log(const QString &name, const qint64 nsecs);
+
+private:
+    struct Phase
+    {
+        QString name;
+        qint64 nsecs;
+    };
+
+    bool m_finished;
+    bool m_loggerReady;
+    QElapsedTimer m_timer;
+    QVector<Phase> m_phases;
+};
+}
+
+#endif
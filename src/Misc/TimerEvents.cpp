@@ -38,7 +38,16 @@ static TimerEvents *INSTANCE = nullptr;
  * Constructor function
  */
 TimerEvents::TimerEvents()
+    : m_virtualTime(false)
+    , m_virtualMsecs(0)
+    , m_offsetNsecs(0)
+    , m_next1Hz(0)
+    , m_next5Hz(0)
+    , m_next42Hz(0)
 {
+    // Start monotonic clock
+    m_clock.start();
+
     // Configure timeout intevals
     m_timer1Hz.setInterval(HZ_TO_MS(1));
     m_timer5Hz.setInterval(HZ_TO_MS(5));
@@ -53,6 +62,10 @@ TimerEvents::TimerEvents()
     connect(&m_timer1Hz, &QTimer::timeout, this, &TimerEvents::timeout1Hz);
     connect(&m_timer5Hz, &QTimer::timeout, this, &TimerEvents::timeout5Hz);
     connect(&m_timer42Hz, &QTimer::timeout, this, &TimerEvents::timeout42Hz);
+
+    // Virtual time runs one step per event loop iteration
+    m_virtualTimer.setInterval(0);
+    connect(&m_virtualTimer, &QTimer::timeout, this, &TimerEvents::runVirtualTick);
     LOG_TRACE() << "Class initialized";
 }
 
@@ -67,11 +80,40 @@ TimerEvents *TimerEvents::getInstance()
     return INSTANCE;
 }
 
+/**
+ * Returns @c true if the timer signals are driven by virtual time
+ */
+bool TimerEvents::virtualTime() const
+{
+    return m_virtualTime;
+}
+
+/**
+ * Returns the number of milliseconds elapsed since the module was created
+ */
+qint64 TimerEvents::elapsed() const
+{
+    return nsecsElapsed() / 1000000;
+}
+
+/**
+ * Returns the number of nanoseconds elapsed since the module was created, in virtual
+ * time mode the clock only moves when virtual time is advanced.
+ */
+qint64 TimerEvents::nsecsElapsed() const
+{
+    if (m_virtualTime)
+        return m_virtualMsecs * 1000000;
+
+    return m_clock.nsecsElapsed() + m_offsetNsecs;
+}
+
 /**
  * Stops all the timers of this module
  */
 void TimerEvents::stopTimers()
 {
+    m_virtualTimer.stop();
     m_timer1Hz.stop();
     m_timer5Hz.stop();
     m_timer42Hz.stop();
@@ -84,9 +126,104 @@ void TimerEvents::stopTimers()
  */
 void TimerEvents::startTimers()
 {
+    if (m_virtualTime)
+    {
+        m_virtualTimer.start();
+        LOG_INFO() << "Timers started in virtual time mode";
+        return;
+    }
+
     m_timer1Hz.start();
     m_timer5Hz.start();
     m_timer42Hz.start();
 
     LOG_TRACE() << "Timers started";
 }
+
+/**
+ * Moves the virtual clock forward by @a msecs milliseconds & emits the timer signals
+ * that are due, in the same order in which they would be emitted in real time. Signals
+ * that are due at the same time are emitted from the slowest to the fastest timer.
+ */
+void TimerEvents::advance(const qint64 msecs)
+{
+    if (!m_virtualTime || msecs < 0)
+        return;
+
+    const auto target = m_virtualMsecs + msecs;
+    while (true)
+    {
+        const auto next = qMin(m_next1Hz, qMin(m_next5Hz, m_next42Hz));
+        if (next > target)
+            break;
+
+        m_virtualMsecs = next;
+        if (m_next1Hz == next)
+        {
+            m_next1Hz += m_timer1Hz.interval();
+            emit timeout1Hz();
+        }
+
+        if (m_next5Hz == next)
+        {
+            m_next5Hz += m_timer5Hz.interval();
+            emit timeout5Hz();
+        }
+
+        if (m_next42Hz == next)
+        {
+            m_next42Hz += m_timer42Hz.interval();
+            emit timeout42Hz();
+        }
+    }
+
+    m_virtualMsecs = target;
+}
+
+/**
+ * Switches between wall-clock & virtual time. The virtual clock continues from the
+ * current real time & the wall clock continues from the virtual time when it is ahead,
+ * so the modules never observe time going backwards.
+ */
+void TimerEvents::setVirtualTime(const bool enabled)
+{
+    if (m_virtualTime == enabled)
+        return;
+
+    // Stop timers of the current mode
+    const auto running = m_timer1Hz.isActive() || m_virtualTimer.isActive();
+    stopTimers();
+
+    // Synchronize virtual clock & schedule
+    if (enabled)
+    {
+        m_virtualMsecs = elapsed();
+        m_next1Hz = m_virtualMsecs + m_timer1Hz.interval();
+        m_next5Hz = m_virtualMsecs + m_timer5Hz.interval();
+        m_next42Hz = m_virtualMsecs + m_timer42Hz.interval();
+    }
+
+    // Continue wall clock from virtual time
+    else
+    {
+        const auto wall = m_clock.nsecsElapsed() + m_offsetNsecs;
+        const auto virt = m_virtualMsecs * 1000000;
+        if (virt > wall)
+            m_offsetNsecs += virt - wall;
+    }
+
+    // Change mode & restart timers
+    m_virtualTime = enabled;
+    if (running)
+        startTimers();
+}
+
+/**
+ * Advances virtual time to the next timer event, the event loop processes pending
+ * events (e.g. network I/O) between two virtual ticks.
+ */
+void TimerEvents::runVirtualTick()
+{
+    const auto next = qMin(m_next1Hz, qMin(m_next5Hz, m_next42Hz));
+    advance(next - m_virtualMsecs);
+}
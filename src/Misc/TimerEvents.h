@@ -25,9 +25,21 @@
 
 #include <QTimer>
 #include <QObject>
+#include <QElapsedTimer>
 
 namespace Misc
 {
+/**
+ * Periodic timer signals shared by all the modules of the application.
+ *
+ * By default the signals are driven by the wall clock. In virtual time mode, the time
+ * only advances when advance() is called or, after startTimers(), as fast as the event
+ * loop allows. The signals are emitted in the same order as in a real-time run, which
+ * allows stepping through a full simulation profile in a fraction of its duration.
+ *
+ * Modules that measure timeouts or schedule actions must read the time with
+ * nsecsElapsed() or elapsed(), so that they follow the virtual clock.
+ */
 class TimerEvents : public QObject
 {
     Q_OBJECT
@@ -40,14 +52,32 @@ signals:
 public:
     static TimerEvents *getInstance();
 
+    bool virtualTime() const;
+    qint64 elapsed() const;
+    qint64 nsecsElapsed() const;
+
 public slots:
     void stopTimers();
     void startTimers();
+    void advance(const qint64 msecs);
+    void setVirtualTime(const bool enabled);
+
+private slots:
+    void runVirtualTick();
 
 private:
     TimerEvents();
 
 private:
+    bool m_virtualTime;
+    qint64 m_virtualMsecs;
+    qint64 m_offsetNsecs;
+    qint64 m_next1Hz;
+    qint64 m_next5Hz;
+    qint64 m_next42Hz;
+    QTimer m_virtualTimer;
+    QElapsedTimer m_clock;
+
     QTimer m_timer1Hz;
     QTimer m_timer5Hz;
     QTimer m_timer42Hz;
@@ -0,0 +1,378 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Watchdog.h"
+#include "Metrics.h"
+#include "TimerEvents.h"
+
+#include <algorithm>
+
+#include <QEvent>
+#include <QDateTime>
+#include <QSettings>
+#include <QMetaEnum>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <Logger.h>
+
+using namespace Misc;
+
+/*
+ * Interval (in ms) between heartbeats sent to the GUI thread
+ */
+#define HEARTBEAT_INTERVAL 20
+
+/*
+ * Default time (in ms) that the event loop can be blocked before registering a stall
+ */
+#define DEFAULT_STALL_THRESHOLD 100
+
+/*
+ * Maximum number of stalls displayed by the user interface
+ */
+#define MAX_STALLS 20
+
+/*
+ * Monotonic clock shared by the GUI & watchdog threads
+ */
+static QElapsedTimer CLOCK;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static Watchdog *INSTANCE = nullptr;
+
+/**
+ * Constructor function
+ */
+WatchdogWorker::WatchdogWorker(Watchdog *watchdog)
+    : m_timer(nullptr)
+    , m_watchdog(watchdog)
+{
+}
+
+/**
+ * Starts sending heartbeats, the timer is created in the watchdog thread
+ */
+void WatchdogWorker::start()
+{
+    m_timer = new QTimer(this);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    m_timer->setInterval(HEARTBEAT_INTERVAL);
+    connect(m_timer, &QTimer::timeout, this, &WatchdogWorker::check);
+    m_timer->start();
+}
+
+/**
+ * Sends a new heartbeat if the previous one was processed, otherwise checks if the
+ * event loop has been blocked for longer than the stall threshold & records the handler
+ * that is currently running in the GUI thread.
+ */
+void WatchdogWorker::check()
+{
+    const auto now = CLOCK.nsecsElapsed();
+    const auto sent = m_watchdog->m_heartbeatSent.load();
+
+    // Send new heartbeat
+    if (sent < 0)
+    {
+        m_watchdog->m_heartbeatSent.store(now);
+        QMetaObject::invokeMethod(m_watchdog, "onHeartbeat", Qt::QueuedConnection);
+    }
+
+    // Register stall once per heartbeat
+    else if (now - sent > m_watchdog->m_threshold * 1000000
+             && m_watchdog->m_stalledHeartbeat.load() != sent)
+    {
+        const auto start = QDateTime::currentMSecsSinceEpoch() - (now - sent) / 1000000;
+        m_watchdog->m_stallTimestamp.store(start);
+        m_watchdog->m_stallHandler.store(m_watchdog->m_handler.load());
+        m_watchdog->m_stallEventType.store(m_watchdog->m_eventType.load());
+        m_watchdog->m_stalledHeartbeat.store(sent);
+    }
+}
+
+/**
+ * Constructor function, starts the watchdog thread & installs an application-wide
+ * event filter that keeps track of the receiver of the event being dispatched
+ */
+Watchdog::Watchdog()
+    : m_worker(nullptr)
+    , m_heartbeatSent(-1)
+    , m_stalledHeartbeat(-1)
+    , m_stallTimestamp(0)
+    , m_stallEventType(0)
+    , m_stallHandler(nullptr)
+    , m_eventType(0)
+    , m_handler(nullptr)
+    , m_stallCount(0)
+{
+    // Reset samples
+    for (int i = 0; i < SeriesCount; ++i)
+    {
+        m_samples[i].count = 0;
+        m_samples[i].index = 0;
+        m_samples[i].last = -1;
+        m_samples[i].p50 = 0;
+        m_samples[i].p99 = 0;
+        m_samples[i].max = 0;
+    }
+
+    // Read stall threshold
+    CLOCK.start();
+    QSettings settings;
+    auto threshold = settings.value("Watchdog/stallThreshold", DEFAULT_STALL_THRESHOLD);
+    m_threshold = qMax(1, threshold.toInt());
+
+    // Track event receivers
+    qApp->installEventFilter(this);
+
+    // Measure timer intervals & update statistics
+    auto te = TimerEvents::getInstance();
+    connect(te, &TimerEvents::timeout1Hz, this, &Watchdog::onTimeout1Hz);
+    connect(te, &TimerEvents::timeout5Hz, this, &Watchdog::onTimeout5Hz);
+    connect(te, &TimerEvents::timeout42Hz, this, &Watchdog::onTimeout42Hz);
+    connect(te, &TimerEvents::timeout1Hz, this, &Watchdog::update);
+
+    // Start watchdog thread
+    m_worker = new WatchdogWorker(this);
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::started, m_worker, &WatchdogWorker::start);
+    connect(&m_thread, &QThread::finished, m_worker, &WatchdogWorker::deleteLater);
+    connect(qApp, &QApplication::aboutToQuit, this, &Watchdog::stop);
+    m_thread.setObjectName("Watchdog");
+    m_thread.start(QThread::HighestPriority);
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+Watchdog *Watchdog::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new Watchdog;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns the p50/p99/max event loop latency
+ */
+QString Watchdog::latency() const
+{
+    return summary(EventLoop);
+}
+
+/**
+ * Returns the p50/p99/max firing intervals of the application timers
+ */
+QString Watchdog::timers() const
+{
+    return tr("1 Hz timer: %1\n5 Hz timer: %2\n42 Hz timer: %3")
+        .arg(summary(Timer1Hz), summary(Timer5Hz), summary(Timer42Hz));
+}
+
+/**
+ * Returns the number of stalls detected since the application started
+ */
+int Watchdog::stallCount() const
+{
+    return m_stallCount;
+}
+
+/**
+ * Returns the description of the latest stalls, newest first
+ */
+QStringList Watchdog::stalls() const
+{
+    return m_stalls;
+}
+
+/**
+ * Registers the receiver of the event that is about to be dispatched by the GUI thread,
+ * the watchdog thread reads it when the event loop stalls. Events sent to timers are
+ * attributed to the object that owns the timer.
+ */
+bool Watchdog::eventFilter(QObject *object, QEvent *event)
+{
+    auto receiver = object;
+    if (object->metaObject() == &QTimer::staticMetaObject && object->parent())
+        receiver = object->parent();
+
+    m_eventType.store(event->type(), std::memory_order_relaxed);
+    m_handler.store(receiver->metaObject(), std::memory_order_relaxed);
+    return false;
+}
+
+/**
+ * Stops the watchdog thread
+ */
+void Watchdog::stop()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+/**
+ * Calculates the percentiles of the samples registered during the last seconds &
+ * updates the user interface
+ */
+void Watchdog::update()
+{
+    bool changed = false;
+    qint64 values[1024];
+    for (int i = 0; i < SeriesCount; ++i)
+    {
+        auto &samples = m_samples[i];
+        if (samples.count == 0)
+            continue;
+
+        std::copy(samples.values, samples.values + samples.count, values);
+        std::sort(values, values + samples.count);
+
+        const auto p50 = values[samples.count / 2];
+        const auto p99 = values[qMin(samples.count - 1, samples.count * 99 / 100)];
+        const auto max = values[samples.count - 1];
+        if (p50 != samples.p50 || p99 != samples.p99 || max != samples.max)
+        {
+            samples.p50 = p50;
+            samples.p99 = p99;
+            samples.max = max;
+            changed = true;
+        }
+    }
+
+    if (changed)
+        emit statisticsChanged();
+}
+
+/**
+ * Registers the time that the last heartbeat waited in the event loop & reports the
+ * stall detected by the watchdog thread, if any
+ */
+void Watchdog::onHeartbeat()
+{
+    // Register latency & allow the watchdog thread to send a new heartbeat
+    const auto sent = m_heartbeatSent.exchange(-1);
+    const auto latency = CLOCK.nsecsElapsed() - sent;
+    addSample(EventLoop, latency);
+    Metrics::updateMaximum(Metrics::EventLoopLatencyMax, latency / 1000);
+
+    // Check if the watchdog detected a stall while this heartbeat was waiting
+    if (m_stalledHeartbeat.load() != sent)
+        return;
+
+    // Get handler that was running during the stall
+    QString handler = tr("Unknown handler");
+    const auto meta = m_stallHandler.load();
+    if (meta)
+    {
+        const auto type = static_cast<QEvent::Type>(m_stallEventType.load());
+        const auto name = QMetaEnum::fromType<QEvent::Type>().valueToKey(type);
+        handler = QString("%1 (%2)").arg(meta->className(), name ? name : "?");
+    }
+
+    // Register stall
+    const auto time = QDateTime::fromMSecsSinceEpoch(m_stallTimestamp.load());
+    const auto description = tr("%1  %2 ms  %3")
+                                 .arg(time.toString("hh:mm:ss.zzz"))
+                                 .arg(latency / 1000000)
+                                 .arg(handler);
+    LOG_WARNING() << "Event loop stalled for" << latency / 1000000 << "ms in" << handler;
+
+    ++m_stallCount;
+    Metrics::increment(Metrics::EventLoopStalls);
+    m_stalls.prepend(description);
+    if (m_stalls.count() > MAX_STALLS)
+        m_stalls.removeLast();
+
+    emit stallsChanged();
+}
+
+/**
+ * Registers the interval between two 1 Hz timeouts
+ */
+void Watchdog::onTimeout1Hz()
+{
+    addInterval(Timer1Hz);
+}
+
+/**
+ * Registers the interval between two 5 Hz timeouts
+ */
+void Watchdog::onTimeout5Hz()
+{
+    addInterval(Timer5Hz);
+}
+
+/**
+ * Registers the interval between two 42 Hz timeouts
+ */
+void Watchdog::onTimeout42Hz()
+{
+    addInterval(Timer42Hz);
+}
+
+/**
+ * Adds a new sample (in ns) to the given @a series, only the latest samples are kept
+ */
+void Watchdog::addSample(const Series series, const qint64 nsecs)
+{
+    auto &samples = m_samples[series];
+    const int size = sizeof(samples.values) / sizeof(samples.values[0]);
+
+    samples.values[samples.index] = nsecs;
+    samples.index = (samples.index + 1) % size;
+    samples.count = qMin(samples.count + 1, size);
+}
+
+/**
+ * Registers the time elapsed since the previous timeout of the given timer @a series,
+ * intervals are not meaningful in virtual time mode
+ */
+void Watchdog::addInterval(const Series series)
+{
+    if (TimerEvents::getInstance()->virtualTime())
+        return;
+
+    auto &samples = m_samples[series];
+    const auto now = CLOCK.nsecsElapsed();
+    if (samples.last >= 0)
+        addSample(series, now - samples.last);
+
+    samples.last = now;
+}
+
+/**
+ * Returns the p50/p99/max values (in ms) of the given @a series
+ */
+QString Watchdog::summary(const Series series) const
+{
+    const auto &samples = m_samples[series];
+    if (samples.count == 0)
+        return tr("no data");
+
+    return tr("p50 %1 / p99 %2 / max %3 ms")
+        .arg(samples.p50 / 1e6, 0, 'f', 2)
+        .arg(samples.p99 / 1e6, 0, 'f', 2)
+        .arg(samples.max / 1e6, 0, 'f', 2);
+}
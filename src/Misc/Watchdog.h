@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISC_WATCHDOG_H
+#define MISC_WATCHDOG_H
+
+#include <atomic>
+
+#include <QTimer>
+#include <QThread>
+#include <QObject>
+#include <QStringList>
+
+namespace Misc
+{
+class Watchdog;
+
+/**
+ * Sends heartbeats to the GUI thread from the watchdog thread & detects the heartbeats
+ * that are not answered within the stall threshold.
+ */
+class WatchdogWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WatchdogWorker(Watchdog *watchdog);
+
+public slots:
+    void start();
+
+private slots:
+    void check();
+
+private:
+    QTimer *m_timer;
+    Watchdog *m_watchdog;
+};
+
+/**
+ * Measures the health of the GUI event loop. A watchdog thread posts heartbeats to the
+ * event loop & measures how long they take to be processed, the actual firing intervals
+ * of the @c TimerEvents timers are measured as well.
+ *
+ * When a heartbeat is not processed within the stall threshold, the watchdog thread
+ * records the time & the handler that the GUI thread is running (the receiver of the
+ * last event dispatched by the event loop), so that the stall can be reported once the
+ * event loop recovers.
+ */
+class Watchdog : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(QString latency
+               READ latency
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(QString timers
+               READ timers
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(int stallCount
+               READ stallCount
+               NOTIFY stallsChanged)
+    Q_PROPERTY(QStringList stalls
+               READ stalls
+               NOTIFY stallsChanged)
+    // clang-format on
+
+signals:
+    void stallsChanged();
+    void statisticsChanged();
+
+public:
+    static Watchdog *getInstance();
+
+    QString latency() const;
+    QString timers() const;
+    int stallCount() const;
+    QStringList stalls() const;
+
+    bool eventFilter(QObject *object, QEvent *event) override;
+
+private slots:
+    void stop();
+    void update();
+    void onHeartbeat();
+    void onTimeout1Hz();
+    void onTimeout5Hz();
+    void onTimeout42Hz();
+
+private:
+    Watchdog();
+
+    enum Series
+    {
+        EventLoop,
+        Timer1Hz,
+        Timer5Hz,
+        Timer42Hz,
+        SeriesCount,
+    };
+
+    void addSample(const Series series, const qint64 nsecs);
+    void addInterval(const Series series);
+    QString summary(const Series series) const;
+
+private:
+    friend class WatchdogWorker;
+
+    QThread m_thread;
+    qint64 m_threshold;
+    WatchdogWorker *m_worker;
+
+    std::atomic<qint64> m_heartbeatSent;
+    std::atomic<qint64> m_stalledHeartbeat;
+    std::atomic<qint64> m_stallTimestamp;
+    std::atomic<int> m_stallEventType;
+    std::atomic<const QMetaObject *> m_stallHandler;
+    std::atomic<int> m_eventType;
+    std::atomic<const QMetaObject *> m_handler;
+
+    int m_stallCount;
+    QStringList m_stalls;
+
+    struct Samples
+    {
+        int count;
+        int index;
+        qint64 last;
+        qint64 values[1024];
+        qint64 p50;
+        qint64 p99;
+        qint64 max;
+    };
+
+    Samples m_samples[SeriesCount];
+};
+}
+
+#endif
@@ -0,0 +1,459 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Expression.h"
+
+#include <QtMath>
+
+using namespace Mission;
+
+/*
+ * Maximum depth of the evaluation stack, expressions that need a deeper stack are
+ * rejected by the compiler
+ */
+#define MAX_STACK_DEPTH 32
+
+/*
+ * Names of the variables, in the same order as the Variable enum
+ */
+static const char *VARIABLE_NAMES[] = {
+    "source",      "packetCount", "missionTime",  "altitude",    "temperature",
+    "voltage",     "gpsAltitude", "gpsSats",      "sp1Released", "sp2Released",
+    "rotationRate", "descentRate", "clockDrift",
+};
+
+/**
+ * Returns @c true if @a value is not zero & is a number
+ */
+static inline bool truth(const double value)
+{
+    return value != 0 && !qIsNaN(value);
+}
+
+/**
+ * Constructor function, creates an invalid expression
+ */
+Expression::Expression()
+    : m_variables(0)
+{
+}
+
+/**
+ * Returns @c true if the expression was compiled successfully
+ */
+bool Expression::isValid() const
+{
+    return !m_program.isEmpty();
+}
+
+/**
+ * Returns the source text of the expression
+ */
+QString Expression::text() const
+{
+    return m_text;
+}
+
+/**
+ * Returns the compilation error, if any
+ */
+QString Expression::error() const
+{
+    return m_error;
+}
+
+/**
+ * Returns the variables used by the expression
+ */
+QList<int> Expression::variables() const
+{
+    QList<int> list;
+    for (int i = 0; i < VariableCount; ++i)
+    {
+        if (m_variables & (1u << i))
+            list.append(i);
+    }
+
+    return list;
+}
+
+/**
+ * Evaluates the expression with the given @a inputs, which must contain a value for
+ * each variable. Boolean results are returned as 1 (true) or 0 (false).
+ */
+double Expression::evaluate(const double *inputs) const
+{
+    if (m_program.isEmpty())
+        return qQNaN();
+
+    int top = 0;
+    double stack[MAX_STACK_DEPTH];
+    const auto program = m_program.constData();
+    const auto size = m_program.size();
+    for (int i = 0; i < size; ++i)
+    {
+        const auto &instruction = program[i];
+
+        // Operands & unary operators
+        switch (instruction.op)
+        {
+            case PushConstant:
+                stack[top++] = instruction.value;
+                continue;
+            case PushVariable:
+                stack[top++] = inputs[instruction.variable];
+                continue;
+            case Negate:
+                stack[top - 1] = -stack[top - 1];
+                continue;
+            case Not:
+                stack[top - 1] = truth(stack[top - 1]) ? 0 : 1;
+                continue;
+            case Abs:
+                stack[top - 1] = qAbs(stack[top - 1]);
+                continue;
+            default:
+                break;
+        }
+
+        // Binary operators
+        const double b = stack[--top];
+        const double a = stack[top - 1];
+        double result = 0;
+        switch (instruction.op)
+        {
+            case Or:
+                result = truth(a) || truth(b);
+                break;
+            case And:
+                result = truth(a) && truth(b);
+                break;
+            case Equal:
+                result = a == b;
+                break;
+            case NotEqual:
+                result = !qIsNaN(a) && !qIsNaN(b) && a != b;
+                break;
+            case Less:
+                result = a < b;
+                break;
+            case LessEqual:
+                result = a <= b;
+                break;
+            case Greater:
+                result = a > b;
+                break;
+            case GreaterEqual:
+                result = a >= b;
+                break;
+            case Add:
+                result = a + b;
+                break;
+            case Subtract:
+                result = a - b;
+                break;
+            case Multiply:
+                result = a * b;
+                break;
+            case Divide:
+                result = a / b;
+                break;
+            default:
+                break;
+        }
+
+        stack[top - 1] = result;
+    }
+
+    return stack[0];
+}
+
+/**
+ * Returns the name of the given @a variable, as used in expressions
+ */
+QString Expression::variableName(const int variable)
+{
+    if (variable >= 0 && variable < VariableCount)
+        return VARIABLE_NAMES[variable];
+
+    return QString();
+}
+
+/**
+ * Compiles the given expression @a text with the shunting-yard algorithm. If the
+ * expression is not valid, the returned object contains the reason in error().
+ */
+Expression Expression::compile(const QString &text)
+{
+    Expression expression;
+    expression.m_text = text.trimmed();
+
+    // clang-format off
+    auto fail = [&](const QString &error) {
+        expression.m_error = error;
+        expression.m_program.clear();
+        expression.m_variables = 0;
+        return expression;
+    };
+    // clang-format on
+
+    // Output queue & operator stack
+    QVector<Instruction> ops;
+    QVector<Instruction> &out = expression.m_program;
+
+    // Parse tokens
+    int i = 0;
+    bool expectOperand = true;
+    const auto &s = expression.m_text;
+    while (i < s.length())
+    {
+        const auto c = s.at(i);
+
+        // Skip whitespace
+        if (c.isSpace())
+        {
+            ++i;
+            continue;
+        }
+
+        // Numeric constant
+        if (c.isDigit() || c == '.')
+        {
+            if (!expectOperand)
+                return fail(tr("Unexpected number at position %1").arg(i + 1));
+
+            const int start = i;
+            while (i < s.length() && (s.at(i).isDigit() || s.at(i) == '.'))
+                ++i;
+
+            bool ok = false;
+            const auto value = s.mid(start, i - start).toDouble(&ok);
+            if (!ok)
+                return fail(tr("Invalid number at position %1").arg(start + 1));
+
+            out.append({PushConstant, -1, value});
+            expectOperand = false;
+            continue;
+        }
+
+        // Variables, source constants & functions
+        if (c.isLetter() || c == '_')
+        {
+            if (!expectOperand)
+                return fail(tr("Unexpected name at position %1").arg(i + 1));
+
+            const int start = i;
+            while (i < s.length() && (s.at(i).isLetterOrNumber() || s.at(i) == '_'))
+                ++i;
+
+            const auto name = s.mid(start, i - start);
+            if (name == "abs")
+            {
+                ops.append({Abs, -1, 0});
+                continue;
+            }
+
+            if (name == "C" || name == "S1" || name == "S2")
+            {
+                const double source = name == "C" ? 0.0 : name == "S1" ? 1.0 : 2.0;
+                out.append({PushConstant, -1, source});
+                expectOperand = false;
+                continue;
+            }
+
+            int variable = -1;
+            for (int j = 0; j < VariableCount; ++j)
+            {
+                if (name == VARIABLE_NAMES[j])
+                    variable = j;
+            }
+
+            if (variable < 0)
+                return fail(tr("Unknown variable \"%1\"").arg(name));
+
+            out.append({PushVariable, variable, 0});
+            expression.m_variables |= 1u << variable;
+            expectOperand = false;
+            continue;
+        }
+
+        // Opening parenthesis
+        if (c == '(')
+        {
+            if (!expectOperand)
+                return fail(tr("Unexpected \"(\" at position %1").arg(i + 1));
+
+            ops.append({LeftParenthesis, -1, 0});
+            ++i;
+            continue;
+        }
+
+        // Closing parenthesis, also completes function calls
+        if (c == ')')
+        {
+            if (expectOperand)
+                return fail(tr("Unexpected \")\" at position %1").arg(i + 1));
+
+            while (!ops.isEmpty() && ops.last().op != LeftParenthesis)
+                out.append(ops.takeLast());
+
+            if (ops.isEmpty())
+                return fail(tr("Unbalanced \")\" at position %1").arg(i + 1));
+
+            ops.removeLast();
+            if (!ops.isEmpty() && ops.last().op == Abs)
+                out.append(ops.takeLast());
+
+            ++i;
+            continue;
+        }
+
+        // Get operator
+        OpCode op;
+        const auto pair = s.mid(i, 2);
+        if (pair == "||")
+            op = Or;
+        else if (pair == "&&")
+            op = And;
+        else if (pair == "==")
+            op = Equal;
+        else if (pair == "!=")
+            op = NotEqual;
+        else if (pair == "<=")
+            op = LessEqual;
+        else if (pair == ">=")
+            op = GreaterEqual;
+        else if (c == '<')
+            op = Less;
+        else if (c == '>')
+            op = Greater;
+        else if (c == '+')
+            op = Add;
+        else if (c == '-')
+            op = expectOperand ? Negate : Subtract;
+        else if (c == '*')
+            op = Multiply;
+        else if (c == '/')
+            op = Divide;
+        else if (c == '!')
+            op = Not;
+        else
+            return fail(
+                tr("Unknown character \"%1\" at position %2").arg(c).arg(i + 1));
+
+        i += (op == Or || op == And || op == Equal || op == NotEqual || op == LessEqual
+              || op == GreaterEqual)
+            ? 2
+            : 1;
+
+        // Unary operators are applied to the next operand
+        if (isUnary(op))
+        {
+            if (!expectOperand)
+                return fail(tr("Unexpected operator at position %1").arg(i));
+
+            ops.append({op, -1, 0});
+            continue;
+        }
+
+        // Binary operators, all of them are left-associative
+        if (expectOperand)
+            return fail(tr("Missing operand at position %1").arg(i));
+
+        while (!ops.isEmpty() && ops.last().op != LeftParenthesis
+               && precedence(ops.last().op) >= precedence(op))
+            out.append(ops.takeLast());
+
+        ops.append({op, -1, 0});
+        expectOperand = true;
+    }
+
+    // Expression ends with an operator
+    if (expectOperand)
+        return fail(tr("Incomplete expression"));
+
+    // Move remaining operators to the output queue
+    while (!ops.isEmpty())
+    {
+        if (ops.last().op == LeftParenthesis || ops.last().op == Abs)
+            return fail(tr("Missing \")\""));
+
+        out.append(ops.takeLast());
+    }
+
+    // Verify that the program can be evaluated with the fixed-size stack
+    int depth = 0;
+    foreach (const auto &instruction, out)
+    {
+        if (instruction.op == PushConstant || instruction.op == PushVariable)
+            ++depth;
+        else if (!isUnary(instruction.op))
+            --depth;
+
+        if (depth < 1 || depth > MAX_STACK_DEPTH)
+            return fail(tr("Expression is too complex"));
+    }
+
+    if (depth != 1)
+        return fail(tr("Incomplete expression"));
+
+    return expression;
+}
+
+/**
+ * Returns the precedence of the given binary operator, unary operators are always
+ * applied before binary operators
+ */
+int Expression::precedence(const OpCode op)
+{
+    switch (op)
+    {
+        case Or:
+            return 1;
+        case And:
+            return 2;
+        case Equal:
+        case NotEqual:
+            return 3;
+        case Less:
+        case LessEqual:
+        case Greater:
+        case GreaterEqual:
+            return 4;
+        case Add:
+        case Subtract:
+            return 5;
+        case Multiply:
+        case Divide:
+            return 6;
+        default:
+            return 7;
+    }
+}
+
+/**
+ * Returns @c true if the given operator takes a single operand
+ */
+bool Expression::isUnary(const OpCode op)
+{
+    return op == Negate || op == Not || op == Abs;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISSION_EXPRESSION_H
+#define MISSION_EXPRESSION_H
+
+#include <QList>
+#include <QString>
+#include <QVector>
+#include <QCoreApplication>
+
+namespace Mission
+{
+/**
+ * Boolean/arithmetic expression over telemetry variables, for example:
+ *
+ *     source == C && altitude > 400 && altitude < 500 && descentRate > 5
+ *
+ * Expressions are compiled once to a flat program in reverse polish notation, which is
+ * evaluated with a fixed-size stack & without allocating memory. Supported operators
+ * are || && == != < <= > >= + - * / ! (unary -) & the abs() function. Variables that
+ * are not available for a packet are NaN, so any comparison with them is false.
+ */
+class Expression
+{
+    Q_DECLARE_TR_FUNCTIONS(Expression)
+
+public:
+    enum Variable
+    {
+        Source,
+        PacketCount,
+        MissionTime,
+        Altitude,
+        Temperature,
+        Voltage,
+        GpsAltitude,
+        GpsSats,
+        Sp1Released,
+        Sp2Released,
+        RotationRate,
+        DescentRate,
+        ClockDrift,
+        VariableCount,
+    };
+
+    Expression();
+
+    bool isValid() const;
+    QString text() const;
+    QString error() const;
+    QList<int> variables() const;
+
+    double evaluate(const double *inputs) const;
+
+    static QString variableName(const int variable);
+    static Expression compile(const QString &text);
+
+private:
+    enum OpCode
+    {
+        PushConstant,
+        PushVariable,
+        Or,
+        And,
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Negate,
+        Not,
+        Abs,
+        LeftParenthesis,
+    };
+
+    struct Instruction
+    {
+        OpCode op;
+        int variable;
+        double value;
+    };
+
+    static int precedence(const OpCode op);
+    static bool isUnary(const OpCode op);
+
+private:
+    QString m_text;
+    QString m_error;
+    quint32 m_variables;
+    QVector<Instruction> m_program;
+};
+}
+
+#endif
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "PressureProfile.h"
+
+#include <QtMath>
+#include <QtConcurrent>
+
+using namespace Mission;
+
+/*
+ * Physical pressure range (in Pa) accepted in a profile, a bit wider than the pressures
+ * that can be found between the highest launch sites & sea level
+ */
+#define MIN_PRESSURE 30000
+#define MAX_PRESSURE 110000
+
+/*
+ * Maximum pressure change (in Pa) between two consecutive rows (1 s apart), roughly
+ * equivalent to a vertical speed of 200 m/s near ground level
+ */
+#define MAX_RATE 2500
+
+/*
+ * Standard sea-level pressure (in Pa), used as ground reference when the first row of
+ * the profile is not valid
+ */
+#define SEA_LEVEL_PRESSURE 101325
+
+/*
+ * Profiles with less rows than this are validated in the calling thread
+ */
+#define PARALLEL_THRESHOLD 4096
+
+/*
+ * Maximum number of errors listed in the validation report
+ */
+#define MAX_REPORTED_ERRORS 20
+
+/**
+ * Constructor function, creates an empty (invalid) profile
+ */
+PressureProfile::PressureProfile()
+    : m_rowCount(0)
+    , m_minPressure(0)
+    , m_maxPressure(0)
+    , m_maxRate(0)
+{
+}
+
+/**
+ * Returns @c true if the profile has at least one row & no errors
+ */
+bool PressureProfile::isValid() const
+{
+    return m_rowCount > 0 && m_errors.isEmpty();
+}
+
+/**
+ * Returns the number of rows of the profile
+ */
+int PressureProfile::rowCount() const
+{
+    return m_rowCount;
+}
+
+/**
+ * Returns a human-readable summary of the profile & the first validation errors
+ */
+QString PressureProfile::report() const
+{
+    // Empty profile
+    if (m_rowCount == 0)
+        return tr("The profile does not contain any rows");
+
+    // Generate summary
+    double peak = 0;
+    foreach (auto altitude, m_altitudes)
+    {
+        if (!qIsNaN(altitude))
+            peak = qMax(peak, altitude);
+    }
+
+    auto text = tr("%1 rows, %2 errors").arg(m_rowCount).arg(m_errors.count());
+    text.append("\n");
+    text.append(tr("Pressure: %1 - %2 Pa, max. rate %3 Pa/s")
+                    .arg(m_minPressure, 0, 'f', 0)
+                    .arg(m_maxPressure, 0, 'f', 0)
+                    .arg(m_maxRate, 0, 'f', 0));
+    text.append("\n");
+    text.append(tr("Peak barometric altitude: %1 m").arg(peak, 0, 'f', 1));
+
+    // List errors
+    for (int i = 0; i < m_errors.count() && i < MAX_REPORTED_ERRORS; ++i)
+    {
+        text.append("\n");
+        text.append(tr("Row %1: %2").arg(m_errors.at(i).row + 1)
+                        .arg(m_errors.at(i).message));
+    }
+
+    if (m_errors.count() > MAX_REPORTED_ERRORS)
+    {
+        text.append("\n");
+        text.append(tr("...and %1 more errors")
+                        .arg(m_errors.count() - MAX_REPORTED_ERRORS));
+    }
+
+    return text;
+}
+
+/**
+ * Returns the validation errors, sorted by row
+ */
+const QVector<PressureProfile::Error> &PressureProfile::errors() const
+{
+    return m_errors;
+}
+
+/**
+ * Returns the pressure of each row, invalid rows are set to NaN
+ */
+const QVector<double> &PressureProfile::pressures() const
+{
+    return m_pressures;
+}
+
+/**
+ * Returns the barometric altitude (relative to the first row) of each row, invalid rows
+ * are set to NaN
+ */
+const QVector<double> &PressureProfile::altitudes() const
+{
+    return m_altitudes;
+}
+
+/**
+ * Returns the altitude (in m) that corresponds to the given @a pressure, relative to the
+ * @a reference pressure, using the international barometric formula
+ */
+double PressureProfile::altitude(const double pressure, const double reference)
+{
+    return 44330.77 * (1 - qPow(pressure / reference, 0.190263));
+}
+
+/**
+ * Validates the given CSV @a rows & derives the barometric altitude of each row
+ */
+PressureProfile PressureProfile::analyze(const QList<QStringList> &rows)
+{
+    PressureProfile profile;
+    profile.m_rowCount = rows.count();
+    if (rows.isEmpty())
+        return profile;
+
+    // Use the first row as ground reference
+    double reference = 0;
+    if (!parse(rows.first(), &reference, nullptr) || reference <= 0)
+        reference = SEA_LEVEL_PRESSURE;
+
+    // Split profile in chunks, one per thread (or a single chunk for small profiles)
+    int chunkCount = 1;
+    if (rows.count() >= PARALLEL_THRESHOLD)
+        chunkCount = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+
+    // Each chunk writes its results to a different section of the output vectors
+    profile.m_pressures.resize(rows.count());
+    profile.m_altitudes.resize(rows.count());
+
+    QVector<Chunk> chunks(chunkCount);
+    const int chunkSize = (rows.count() + chunkCount - 1) / chunkCount;
+    for (int i = 0; i < chunkCount; ++i)
+    {
+        chunks[i].begin = i * chunkSize;
+        chunks[i].end = qMin(rows.count(), (i + 1) * chunkSize);
+        chunks[i].reference = reference;
+        chunks[i].rows = &rows;
+        chunks[i].pressures = profile.m_pressures.data();
+        chunks[i].altitudes = profile.m_altitudes.data();
+        chunks[i].minPressure = qInf();
+        chunks[i].maxPressure = -qInf();
+        chunks[i].maxRate = 0;
+    }
+
+    // Validate chunks
+    if (chunkCount > 1)
+        QtConcurrent::blockingMap(chunks, &PressureProfile::validateChunk);
+    else
+        validateChunk(chunks.first());
+
+    // Merge results in row order
+    profile.m_minPressure = qInf();
+    profile.m_maxPressure = -qInf();
+    foreach (const auto &chunk, chunks)
+    {
+        profile.m_errors += chunk.errors;
+        profile.m_maxRate = qMax(profile.m_maxRate, chunk.maxRate);
+        profile.m_minPressure = qMin(profile.m_minPressure, chunk.minPressure);
+        profile.m_maxPressure = qMax(profile.m_maxPressure, chunk.maxPressure);
+    }
+
+    // No row could be parsed
+    if (profile.m_minPressure > profile.m_maxPressure)
+    {
+        profile.m_minPressure = 0;
+        profile.m_maxPressure = 0;
+    }
+
+    return profile;
+}
+
+/**
+ * Obtains the @a pressure of the given CSV @a row, if the row is not valid, the
+ * function returns @c false & the reason is written to @a error.
+ */
+bool PressureProfile::parse(const QStringList &row, double *pressure, QString *error)
+{
+    // Check column count
+    if (row.count() != 4)
+    {
+        if (error)
+            *error = tr("expected 4 columns, found %1").arg(row.count());
+
+        return false;
+    }
+
+    // Check command header
+    if (row.at(0) != "CMD" || row.at(1) != "1714" || row.at(2) != "SIMP")
+    {
+        if (error)
+            *error = tr("expected \"CMD,1714,SIMP\" header");
+
+        return false;
+    }
+
+    // Check pressure value
+    bool ok = false;
+    *pressure = row.at(3).toDouble(&ok);
+    if (!ok)
+    {
+        if (error)
+            *error = tr("\"%1\" is not a number").arg(row.at(3));
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Validates the rows of the given @a chunk, the row before the chunk is also parsed
+ * so that the rate of change can be checked across chunk boundaries.
+ */
+void PressureProfile::validateChunk(Chunk &chunk)
+{
+    // Get the pressure of the previous row
+    double previous = 0;
+    bool previousValid = false;
+    if (chunk.begin > 0)
+        previousValid = parse(chunk.rows->at(chunk.begin - 1), &previous, nullptr);
+
+    // Validate each row
+    for (int i = chunk.begin; i < chunk.end; ++i)
+    {
+        // Check row format
+        QString message;
+        double pressure = 0;
+        if (!parse(chunk.rows->at(i), &pressure, &message))
+        {
+            chunk.errors.append({i, message});
+            chunk.pressures[i] = qQNaN();
+            chunk.altitudes[i] = qQNaN();
+            previousValid = false;
+            continue;
+        }
+
+        // Register pressure & derived altitude
+        chunk.pressures[i] = pressure;
+        chunk.altitudes[i] = altitude(pressure, chunk.reference);
+        chunk.minPressure = qMin(chunk.minPressure, pressure);
+        chunk.maxPressure = qMax(chunk.maxPressure, pressure);
+
+        // Check physical range
+        if (pressure < MIN_PRESSURE || pressure > MAX_PRESSURE)
+        {
+            chunk.errors.append({i, tr("pressure %1 Pa out of range (%2 - %3 Pa)")
+                                        .arg(pressure)
+                                        .arg(MIN_PRESSURE)
+                                        .arg(MAX_PRESSURE)});
+        }
+
+        // Check rate of change
+        else if (previousValid)
+        {
+            const auto rate = qAbs(pressure - previous);
+            chunk.maxRate = qMax(chunk.maxRate, rate);
+            if (rate > MAX_RATE)
+            {
+                chunk.errors.append({i, tr("pressure changed %1 Pa in 1 s (max. %2 Pa)")
+                                            .arg(rate)
+                                            .arg(MAX_RATE)});
+            }
+        }
+
+        previous = pressure;
+        previousValid = true;
+    }
+}
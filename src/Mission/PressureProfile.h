@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISSION_PRESSURE_PROFILE_H
+#define MISSION_PRESSURE_PROFILE_H
+
+#include <QVector>
+#include <QStringList>
+#include <QCoreApplication>
+
+namespace Mission
+{
+/**
+ * Load-time validation & analysis of a simulated pressure profile. Each row of the
+ * profile must have the form:
+ *
+ *     CMD,1714,SIMP,<pressure in Pa>
+ *
+ * Rows are checked for column count, command format, numeric pressure, physical
+ * pressure range & the maximum pressure change between consecutive rows (which are
+ * sent at 1 Hz). The barometric altitude of every row is derived with respect to the
+ * pressure of the first row (ground level).
+ *
+ * Large profiles are split in chunks that are validated in parallel by the global
+ * thread pool.
+ */
+class PressureProfile
+{
+    Q_DECLARE_TR_FUNCTIONS(PressureProfile)
+
+public:
+    struct Error
+    {
+        int row;
+        QString message;
+    };
+
+    PressureProfile();
+
+    bool isValid() const;
+    int rowCount() const;
+    QString report() const;
+    const QVector<Error> &errors() const;
+    const QVector<double> &pressures() const;
+    const QVector<double> &altitudes() const;
+
+    static double altitude(const double pressure, const double reference);
+    static PressureProfile analyze(const QList<QStringList> &rows);
+
+private:
+    struct Chunk
+    {
+        int begin;
+        int end;
+        double reference;
+        const QList<QStringList> *rows;
+        double *pressures;
+        double *altitudes;
+        QVector<Error> errors;
+        double minPressure;
+        double maxPressure;
+        double maxRate;
+    };
+
+    static bool parse(const QStringList &row, double *pressure, QString *error);
+    static void validateChunk(Chunk &chunk);
+
+private:
+    int m_rowCount;
+    double m_minPressure;
+    double m_maxPressure;
+    double m_maxRate;
+    QVector<Error> m_errors;
+    QVector<double> m_pressures;
+    QVector<double> m_altitudes;
+};
+}
+
+#endif
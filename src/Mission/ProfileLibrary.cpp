@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ProfileLibrary.h"
+#include "PressureProfile.h"
+
+#include <QFile>
+#include <QBuffer>
+#include <QSettings>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include <Logger.h>
+#include <qtcsv/reader.h>
+
+using namespace Mission;
+
+/*
+ * Default memory limit (in MB) of the loaded profiles
+ */
+#define DEFAULT_MEMORY_LIMIT 16
+
+/*
+ * Pointer to singleton instance of class
+ */
+static ProfileLibrary *INSTANCE = nullptr;
+
+/**
+ * Returns the number of rows of the profile
+ */
+int SimulationProfile::rowCount() const
+{
+    return qMax(0, offsets.count() - 1);
+}
+
+/**
+ * Returns the approximate number of bytes used by the profile
+ */
+qint64 SimulationProfile::memoryUsage() const
+{
+    return sizeof(SimulationProfile) + commands.capacity()
+           + offsets.capacity() * sizeof(quint32) + altitudes.capacity() * sizeof(float)
+           + (name.capacity() + path.capacity() + report.capacity()) * sizeof(QChar);
+}
+
+/**
+ * Returns the command that sends the pressure of the given @a row
+ */
+QString SimulationProfile::command(const int row) const
+{
+    if (row < 0 || row >= rowCount())
+        return QString();
+
+    const auto begin = offsets.at(row);
+    return QString::fromUtf8(commands.constData() + begin, offsets.at(row + 1) - begin);
+}
+
+/**
+ * Constructor function
+ */
+ProfileLibrary::ProfileLibrary()
+    : m_clock(0)
+    , m_memoryUsage(0)
+{
+    auto limit = QSettings().value("ProfileLibrary/memoryLimit", DEFAULT_MEMORY_LIMIT);
+    m_memoryLimit = static_cast<qint64>(qMax(1, limit.toInt())) * 1024 * 1024;
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+ProfileLibrary *ProfileLibrary::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new ProfileLibrary;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns the number of loaded profiles
+ */
+int ProfileLibrary::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_entries.count();
+}
+
+/**
+ * Returns the data of the profile at the given @a index
+ */
+QVariant ProfileLibrary::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.count())
+        return QVariant();
+
+    const auto &profile = m_entries.at(index.row()).profile;
+    switch (role)
+    {
+        case NameRole:
+        case Qt::DisplayRole:
+            return profile->name;
+        case PathRole:
+            return profile->path;
+        case RowsRole:
+            return profile->rowCount();
+        case ValidRole:
+            return profile->valid;
+        case ActiveRole:
+            return profile == m_active;
+    }
+
+    return QVariant();
+}
+
+/**
+ * Returns the role names used by the QML interface
+ */
+QHash<int, QByteArray> ProfileLibrary::roleNames() const
+{
+    QHash<int, QByteArray> names;
+    names.insert(NameRole, "name");
+    names.insert(PathRole, "path");
+    names.insert(RowsRole, "rows");
+    names.insert(ValidRole, "valid");
+    names.insert(ActiveRole, "active");
+    return names;
+}
+
+/**
+ * Returns the memory used by the loaded profiles & the memory limit
+ */
+QString ProfileLibrary::memoryUsage() const
+{
+    return tr("%1 profiles, %2 of %3 KB")
+        .arg(m_entries.count())
+        .arg(m_memoryUsage / 1024)
+        .arg(m_memoryLimit / 1024);
+}
+
+/**
+ * Returns the description of the last load error
+ */
+QString ProfileLibrary::errorString() const
+{
+    return m_error;
+}
+
+/**
+ * Returns the profile at the given @a index & marks it as recently used, the lookup
+ * does not depend on the number or size of the loaded profiles
+ */
+SimulationProfilePointer ProfileLibrary::profile(const int index)
+{
+    if (index < 0 || index >= m_entries.count())
+        return SimulationProfilePointer();
+
+    m_entries[index].lastUsed = ++m_clock;
+    return m_entries.at(index).profile;
+}
+
+/**
+ * Reads, validates & stores the simulation profile at the given @a path. A profile that
+ * was already loaded from the same path is replaced. Returns the index of the profile,
+ * or -1 if the file cannot be read.
+ */
+int ProfileLibrary::load(const QString &path)
+{
+    // Open file
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+    {
+        m_error = file.errorString();
+        return -1;
+    }
+
+    // Remove comments & spaces, replace team ID placeholders
+    QByteArray csv;
+    QTextStream in(&file);
+    while (!in.atEnd())
+    {
+        QString line = in.readLine();
+        line.replace(" ", "");
+        if (line.startsWith("#") || line.isEmpty())
+            continue;
+
+        line.replace("$", "1714");
+        csv.append(line.toUtf8());
+        csv.append('\n');
+    }
+
+    // Read CSV data & validate the whole profile
+    QBuffer buffer(&csv);
+    buffer.open(QBuffer::ReadOnly);
+    const auto rows = QtCSV::Reader::readToList(buffer);
+    const auto analysis = PressureProfile::analyze(rows);
+
+    // Store the commands & altitudes in compact arrays
+    auto profile = new SimulationProfile;
+    profile->path = path;
+    profile->name = QFileInfo(path).fileName();
+    profile->valid = analysis.isValid();
+    profile->report = analysis.report();
+    profile->commands.reserve(csv.size() + rows.count());
+    profile->offsets.reserve(rows.count() + 1);
+    profile->altitudes.reserve(rows.count());
+    for (int i = 0; i < rows.count(); ++i)
+    {
+        profile->offsets.append(static_cast<quint32>(profile->commands.size()));
+        profile->commands.append(rows.at(i).join(',').toUtf8());
+        profile->commands.append(';');
+        profile->altitudes.append(static_cast<float>(analysis.altitudes().value(i)));
+    }
+    profile->offsets.append(static_cast<quint32>(profile->commands.size()));
+    profile->commands.squeeze();
+
+    // Register profile, replacing the profile previously loaded from the same path
+    Entry entry;
+    entry.lastUsed = ++m_clock;
+    entry.profile = SimulationProfilePointer(profile);
+    bool replaced = false;
+    for (int i = 0; i < m_entries.count(); ++i)
+    {
+        if (m_entries.at(i).profile->path == path)
+        {
+            replaced = true;
+            m_memoryUsage -= m_entries.at(i).profile->memoryUsage();
+            m_entries[i] = entry;
+            emit dataChanged(this->index(i), this->index(i));
+            break;
+        }
+    }
+
+    if (!replaced)
+    {
+        const int index = m_entries.count();
+        beginInsertRows(QModelIndex(), index, index);
+        m_entries.append(entry);
+        endInsertRows();
+    }
+
+    // Update memory usage
+    m_error.clear();
+    m_memoryUsage += profile->memoryUsage();
+    LOG_INFO() << "Loaded pressure profile" << path << profile->rowCount() << "rows,"
+               << analysis.errors().count() << "errors," << profile->memoryUsage()
+               << "bytes";
+
+    // Evict old profiles if needed, the new profile is kept
+    evict();
+    emit memoryUsageChanged();
+    for (int i = 0; i < m_entries.count(); ++i)
+    {
+        if (m_entries.at(i).profile == entry.profile)
+            return i;
+    }
+
+    return -1;
+}
+
+/**
+ * Registers the profile that is being simulated, so that it is never evicted
+ */
+void ProfileLibrary::setActive(const SimulationProfilePointer &profile)
+{
+    m_active = profile;
+    if (!m_entries.isEmpty())
+        emit dataChanged(index(0), index(m_entries.count() - 1));
+}
+
+/**
+ * Removes the least recently used profiles until the memory used by the library is
+ * within its limit. The active profile & the most recently used profile are kept.
+ */
+void ProfileLibrary::evict()
+{
+    while (m_memoryUsage > m_memoryLimit)
+    {
+        // Find least recently used profile
+        int lru = -1;
+        for (int i = 0; i < m_entries.count(); ++i)
+        {
+            const auto &entry = m_entries.at(i);
+            if (entry.profile == m_active || entry.lastUsed == m_clock)
+                continue;
+
+            if (lru < 0 || entry.lastUsed < m_entries.at(lru).lastUsed)
+                lru = i;
+        }
+
+        // Nothing else can be evicted
+        if (lru < 0)
+        {
+            LOG_WARNING() << "Simulation profiles exceed the memory limit of"
+                          << m_memoryLimit << "bytes";
+            break;
+        }
+
+        // Evict profile
+        const auto profile = m_entries.at(lru).profile;
+        LOG_INFO() << "Evicting pressure profile" << profile->path;
+        m_memoryUsage -= profile->memoryUsage();
+        beginRemoveRows(QModelIndex(), lru, lru);
+        m_entries.remove(lru);
+        endRemoveRows();
+    }
+}
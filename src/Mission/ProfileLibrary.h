@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISSION_PROFILE_LIBRARY_H
+#define MISSION_PROFILE_LIBRARY_H
+
+#include <QVector>
+#include <QSharedPointer>
+#include <QAbstractListModel>
+
+namespace Mission
+{
+/**
+ * Compact, read-only representation of a loaded simulation profile. The commands of
+ * all the rows are stored back to back in a single byte array, each row is located
+ * through its offset. Only the barometric altitude of each row is kept from the
+ * profile analysis.
+ *
+ * Each profile owns its arrays, so that evicting a profile releases its memory at once
+ * & a profile that is still being simulated never depends on the library.
+ */
+struct SimulationProfile
+{
+    QString name;
+    QString path;
+    bool valid;
+    QString report;
+    QByteArray commands;
+    QVector<quint32> offsets;
+    QVector<float> altitudes;
+
+    int rowCount() const;
+    qint64 memoryUsage() const;
+    QString command(const int row) const;
+};
+
+/**
+ * Profiles are shared between the library & the communicator, a profile that is being
+ * simulated stays valid even if the library evicts it.
+ */
+typedef QSharedPointer<const SimulationProfile> SimulationProfilePointer;
+
+/**
+ * Keeps several parsed simulation profiles in memory, so that the user can switch
+ * between them (e.g. nominal, fast-descent & sensor-fault profiles) without reloading
+ * any file.
+ *
+ * The memory used by the profiles is limited, when a new profile exceeds the limit the
+ * least recently used profiles are evicted. The active profile is never evicted.
+ */
+class ProfileLibrary : public QAbstractListModel
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(QString memoryUsage
+               READ memoryUsage
+               NOTIFY memoryUsageChanged)
+    // clang-format on
+
+signals:
+    void memoryUsageChanged();
+
+public:
+    enum Roles
+    {
+        NameRole = Qt::UserRole + 1,
+        PathRole,
+        RowsRole,
+        ValidRole,
+        ActiveRole,
+    };
+
+    static ProfileLibrary *getInstance();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QString memoryUsage() const;
+    QString errorString() const;
+    SimulationProfilePointer profile(const int index);
+
+public slots:
+    int load(const QString &path);
+    void setActive(const SimulationProfilePointer &profile);
+
+private:
+    ProfileLibrary();
+    void evict();
+
+private:
+    struct Entry
+    {
+        quint64 lastUsed;
+        SimulationProfilePointer profile;
+    };
+
+    quint64 m_clock;
+    qint64 m_memoryLimit;
+    qint64 m_memoryUsage;
+    QString m_error;
+    QVector<Entry> m_entries;
+    SimulationProfilePointer m_active;
+};
+}
+
+#endif
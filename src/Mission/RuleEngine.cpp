@@ -0,0 +1,468 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "RuleEngine.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTime>
+#include <QtMath>
+#include <QRegExp>
+#include <QSettings>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QFileDialog>
+#include <QElapsedTimer>
+
+#include <Logger.h>
+#include <Misc/Utilities.h>
+#include <SerialStudio/Communicator.h>
+
+using namespace Mission;
+
+/*
+ * Pointer to singleton instance of class
+ */
+static RuleEngine *INSTANCE = nullptr;
+
+/**
+ * Converts a hh:mm:ss(.ss) time string to seconds, returns NaN if the string is not
+ * a valid time
+ */
+static double secondsFromTime(const QByteArray &time)
+{
+    const auto parts = time.trimmed().split(':');
+    if (parts.count() != 3)
+        return qQNaN();
+
+    bool ok[3];
+    const auto h = parts.at(0).toDouble(&ok[0]);
+    const auto m = parts.at(1).toDouble(&ok[1]);
+    const auto s = parts.at(2).toDouble(&ok[2]);
+    if (!ok[0] || !ok[1] || !ok[2])
+        return qQNaN();
+
+    return h * 3600 + m * 60 + s;
+}
+
+/**
+ * Converts the given telemetry @a field to a number, returns NaN if the field is empty
+ * or not numeric
+ */
+static double number(const QByteArray &field)
+{
+    bool ok = false;
+    const auto value = field.trimmed().toDouble(&ok);
+    return ok ? value : qQNaN();
+}
+
+/**
+ * Constructor function
+ */
+RuleEngine::RuleEngine()
+{
+    for (int i = 0; i < Expression::VariableCount; ++i)
+        m_inputs[i] = qQNaN();
+
+    for (int i = 0; i < Telemetry::SourceCount; ++i)
+        m_history[i].valid = false;
+
+    auto communicator = SerialStudio::Communicator::getInstance();
+    connect(communicator, &SerialStudio::Communicator::packetReceived, this,
+            &RuleEngine::process);
+
+    // Load last rules file (all rules start disarmed)
+    auto path = QSettings().value("RuleEngine/file").toString();
+    if (!path.isEmpty() && QFile::exists(path))
+        load(path);
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+RuleEngine *RuleEngine::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new RuleEngine;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns the number of loaded rules
+ */
+int RuleEngine::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_rules.count();
+}
+
+/**
+ * Returns the data of the rule at the given @a index
+ */
+QVariant RuleEngine::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rules.count())
+        return QVariant();
+
+    const auto &rule = m_rules.at(index.row());
+    switch (role)
+    {
+        case NameRole:
+        case Qt::DisplayRole:
+            return rule.name;
+        case ExpressionRole:
+            return rule.expression.text();
+        case ActionRole:
+            return rule.actionName;
+        case ArmedRole:
+            return rule.armed;
+        case OnceRole:
+            return rule.once;
+        case ResultRole:
+            return rule.lastResult;
+        case FireCountRole:
+            return rule.fireCount;
+        case CostRole:
+            return QString("%1 us").arg(rule.cost / 1000.0, 0, 'f', 2);
+    }
+
+    return QVariant();
+}
+
+/**
+ * Returns the role names used by the QML interface
+ */
+QHash<int, QByteArray> RuleEngine::roleNames() const
+{
+    QHash<int, QByteArray> names;
+    names.insert(NameRole, "name");
+    names.insert(ExpressionRole, "expression");
+    names.insert(ActionRole, "action");
+    names.insert(ArmedRole, "armed");
+    names.insert(OnceRole, "once");
+    names.insert(ResultRole, "result");
+    names.insert(FireCountRole, "fireCount");
+    names.insert(CostRole, "cost");
+    return names;
+}
+
+/**
+ * Returns the name of the loaded rules file
+ */
+QString RuleEngine::fileName() const
+{
+    if (m_fileName.isEmpty())
+        return tr("No rules loaded");
+
+    return QFileInfo(m_fileName).fileName();
+}
+
+/**
+ * Reads & compiles the rules file at the given @a path. All errors are reported at once
+ * & the current rules are kept if the file is not valid.
+ */
+bool RuleEngine::load(const QString &path)
+{
+    // Open file
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+    {
+        Misc::Utilities::showMessageBox(tr("File open error"), file.errorString());
+        return false;
+    }
+
+    // Parse each line
+    int lineNumber = 0;
+    QStringList errors;
+    QVector<Rule> rules;
+    QTextStream in(&file);
+    QRegExp syntax("^(\\w+)\\s*:\\s*when\\s+(.+)\\s+then\\s+(\\w+)(\\s+once)?$",
+                   Qt::CaseInsensitive);
+    while (!in.atEnd())
+    {
+        // Remove comments & skip empty lines
+        ++lineNumber;
+        auto line = in.readLine();
+        line = line.left(line.indexOf('#')).trimmed();
+        if (line.isEmpty())
+            continue;
+
+        // Validate rule syntax
+        if (!syntax.exactMatch(line))
+        {
+            errors.append(
+                tr("Line %1: expected \"name: when <expression> then <action>\"")
+                    .arg(lineNumber));
+            continue;
+        }
+
+        // Compile expression
+        Rule rule;
+        rule.name = syntax.cap(1);
+        rule.expression = Expression::compile(syntax.cap(2));
+        rule.actionName = syntax.cap(3).toUpper();
+        rule.once = !syntax.cap(4).isEmpty();
+        rule.armed = false;
+        rule.fireCount = 0;
+        resetResults(rule);
+        rule.cost = 0;
+        if (!rule.expression.isValid())
+        {
+            errors.append(tr("Line %1: %2").arg(lineNumber).arg(rule.expression.error()));
+            continue;
+        }
+
+        // Get action
+        if (rule.actionName == "SYNC_TIME")
+            rule.action = SyncTime;
+        else if (rule.actionName == "RELEASE_SP1")
+            rule.action = ReleasePayload1;
+        else if (rule.actionName == "RELEASE_SP2")
+            rule.action = ReleasePayload2;
+        else
+        {
+            errors.append(tr("Line %1: unknown action \"%2\"").arg(lineNumber).arg(
+                rule.actionName));
+            continue;
+        }
+
+        rules.append(rule);
+    }
+
+    // Report errors
+    if (!errors.isEmpty())
+    {
+        Misc::Utilities::showMessageBox(tr("Invalid rules file"), errors.join("\n"));
+        return false;
+    }
+
+    // Replace current rules
+    beginResetModel();
+    m_rules = rules;
+    m_fileName = path;
+    endResetModel();
+
+    // Update UI
+    QSettings().setValue("RuleEngine/file", path);
+    LOG_INFO() << "Loaded" << rules.count() << "rules from" << path;
+    emit loaded();
+    return true;
+}
+
+/**
+ * Lets the user select a rules file
+ */
+void RuleEngine::openRules()
+{
+    // clang-format off
+    auto name = QFileDialog::getOpenFileName(Q_NULLPTR,
+                                             tr("Select rules file"),
+                                             QDir::homePath());
+    // clang-format on
+
+    if (!name.isEmpty())
+        load(name);
+}
+
+/**
+ * Arms/disarms the rule at the given @a row. An armed rule fires on the next packet
+ * that satisfies its condition.
+ */
+void RuleEngine::setArmed(const int row, const bool armed)
+{
+    if (row < 0 || row >= m_rules.count() || m_rules.at(row).armed == armed)
+        return;
+
+    m_rules[row].armed = armed;
+    resetResults(m_rules[row]);
+    LOG_INFO() << "Rule" << m_rules.at(row).name << (armed ? "armed" : "disarmed");
+    emit dataChanged(index(row), index(row));
+}
+
+/**
+ * Updates the rule inputs with the given @a packet & evaluates all armed rules
+ */
+void RuleEngine::process(const Telemetry::Packet &packet)
+{
+    // Invalid packets have no inputs & would reset the edge detection
+    if (!packet.isValid())
+        return;
+
+    // Update inputs & derived values
+    updateInputs(packet);
+    const auto source = static_cast<int>(packet.source());
+
+    // Evaluate armed rules
+    QElapsedTimer timer;
+    for (int i = 0; i < m_rules.count(); ++i)
+    {
+        auto &rule = m_rules[i];
+        if (!rule.armed)
+            continue;
+
+        // Evaluate condition
+        timer.start();
+        const bool result = rule.expression.evaluate(m_inputs) != 0;
+        rule.cost = timer.nsecsElapsed();
+
+        // Fire on rising edge of the condition for this source
+        const bool fire = result && !rule.sourceResults[source];
+        rule.sourceResults[source] = result;
+        rule.lastResult = result;
+
+        // Log decision & its inputs
+        QStringList inputs;
+        foreach (auto variable, rule.expression.variables())
+        {
+            const auto name = Expression::variableName(variable);
+            inputs.append(QString("%1=%2").arg(name).arg(m_inputs[variable]));
+        }
+
+        LOG_INFO() << "Rule" << rule.name << (fire ? "FIRED" : result ? "true" : "false")
+                   << inputs.join(", ") << "in" << rule.cost << "ns";
+
+        // Execute action
+        if (fire)
+        {
+            ++rule.fireCount;
+            execute(rule.action);
+            if (rule.once)
+            {
+                rule.armed = false;
+                LOG_INFO() << "Rule" << rule.name << "disarmed after firing";
+            }
+        }
+
+        emit dataChanged(index(i), index(i));
+    }
+}
+
+/**
+ * Obtains the rule inputs from the fields of the given @a packet. Values that are not
+ * part of the packet are set to NaN.
+ */
+void RuleEngine::updateInputs(const Telemetry::Packet &packet)
+{
+    // Reset inputs
+    for (int i = 0; i < Expression::VariableCount; ++i)
+        m_inputs[i] = qQNaN();
+
+    // Ignore invalid packets
+    if (!packet.isValid())
+        return;
+
+    // Common header
+    m_inputs[Expression::Source] = static_cast<int>(packet.source());
+    m_inputs[Expression::PacketCount] = packet.packetCount();
+    m_inputs[Expression::MissionTime]
+        = secondsFromTime(packet.field(Telemetry::ContainerField::MissionTime));
+
+    // Container fields
+    if (packet.source() == Telemetry::Source::Container)
+    {
+        using namespace Telemetry;
+        m_inputs[Expression::Altitude] = number(packet.field(ContainerField::Altitude));
+        m_inputs[Expression::Temperature]
+            = number(packet.field(ContainerField::Temperature));
+        m_inputs[Expression::Voltage] = number(packet.field(ContainerField::Voltage));
+        m_inputs[Expression::GpsAltitude]
+            = number(packet.field(ContainerField::GpsAltitude));
+        m_inputs[Expression::GpsSats] = number(packet.field(ContainerField::GpsSats));
+        m_inputs[Expression::Sp1Released]
+            = packet.field(ContainerField::Sp1Released).trimmed() == "R" ? 1 : 0;
+        m_inputs[Expression::Sp2Released]
+            = packet.field(ContainerField::Sp2Released).trimmed() == "R" ? 1 : 0;
+    }
+
+    // Payload fields
+    else
+    {
+        using namespace Telemetry;
+        m_inputs[Expression::Altitude] = number(packet.field(PayloadField::Altitude));
+        m_inputs[Expression::Temperature]
+            = number(packet.field(PayloadField::Temperature));
+        m_inputs[Expression::RotationRate]
+            = number(packet.field(PayloadField::RotationRate));
+    }
+
+    // Clock drift between the ground station & the mission time, wrapped to +/- 12 h
+    const auto missionTime = m_inputs[Expression::MissionTime];
+    if (!qIsNaN(missionTime))
+    {
+        const auto now = QTime::currentTime().msecsSinceStartOfDay() / 1000.0;
+        auto drift = now - missionTime;
+        if (drift > 43200)
+            drift -= 86400;
+        else if (drift < -43200)
+            drift += 86400;
+
+        m_inputs[Expression::ClockDrift] = drift;
+    }
+
+    // Descent rate from the previous packet of the same source
+    const auto altitude = m_inputs[Expression::Altitude];
+    auto &history = m_history[static_cast<int>(packet.source())];
+    if (!qIsNaN(altitude) && !qIsNaN(missionTime))
+    {
+        const auto elapsed = missionTime - history.missionTime;
+        if (history.valid && elapsed > 0)
+            m_inputs[Expression::DescentRate] = (history.altitude - altitude) / elapsed;
+
+        history.valid = true;
+        history.altitude = altitude;
+        history.missionTime = missionTime;
+    }
+}
+
+/**
+ * Sends the command associated with the given @a action
+ */
+void RuleEngine::execute(const Action action)
+{
+    auto communicator = SerialStudio::Communicator::getInstance();
+    switch (action)
+    {
+        case SyncTime:
+            communicator->updateContainerTime();
+            break;
+        case ReleasePayload1:
+            communicator->releasePayload1();
+            break;
+        case ReleasePayload2:
+            communicator->releasePayload2();
+            break;
+    }
+}
+
+/**
+ * Clears the previous results of the given @a rule, so that it can fire again as soon
+ * as its condition is satisfied
+ */
+void RuleEngine::resetResults(Rule &rule)
+{
+    rule.lastResult = false;
+    for (int i = 0; i < Telemetry::SourceCount; ++i)
+        rule.sourceResults[i] = false;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISSION_RULE_ENGINE_H
+#define MISSION_RULE_ENGINE_H
+
+#include <QVector>
+#include <QAbstractListModel>
+
+#include <Mission/Expression.h>
+#include <Telemetry/Packet.h>
+
+namespace Mission
+{
+/**
+ * Sends commands automatically when the received telemetry satisfies a condition. Each
+ * line of a rules file defines a rule:
+ *
+ *     # name: when <expression> then <action> [once]
+ *     sp1: when source == C && altitude < 500 && descentRate > 5 then RELEASE_SP1 once
+ *     resync: when abs(clockDrift) > 2 then SYNC_TIME
+ *
+ * Rule expressions are compiled when the file is loaded & evaluated for every packet.
+ * A rule only fires while it is armed, when its condition changes from false to true.
+ * The previous result is kept per telemetry source, so that packets of other sources
+ * (which do not provide the same fields) do not reset the edge detection. Rules marked
+ * as "once" are disarmed after firing. All rules are disarmed when they are loaded.
+ *
+ * Every evaluation of an armed rule is logged with the values of its inputs.
+ */
+class RuleEngine : public QAbstractListModel
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(QString fileName
+               READ fileName
+               NOTIFY loaded)
+    // clang-format on
+
+signals:
+    void loaded();
+
+public:
+    enum Action
+    {
+        SyncTime,
+        ReleasePayload1,
+        ReleasePayload2,
+    };
+
+    enum Roles
+    {
+        NameRole = Qt::UserRole + 1,
+        ExpressionRole,
+        ActionRole,
+        ArmedRole,
+        OnceRole,
+        ResultRole,
+        FireCountRole,
+        CostRole,
+    };
+
+    static RuleEngine *getInstance();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QString fileName() const;
+    bool load(const QString &path);
+
+public slots:
+    void openRules();
+    void setArmed(const int row, const bool armed);
+    void process(const Telemetry::Packet &packet);
+
+private:
+    RuleEngine();
+    void updateInputs(const Telemetry::Packet &packet);
+    static void resetResults(Rule &rule);
+    void execute(const Action action);
+
+private:
+    struct Rule
+    {
+        QString name;
+        Expression expression;
+        Action action;
+        QString actionName;
+        bool once;
+        bool armed;
+        bool lastResult;
+        bool sourceResults[Telemetry::SourceCount];
+        int fireCount;
+        qint64 cost;
+    };
+
+    struct History
+    {
+        bool valid;
+        double altitude;
+        double missionTime;
+    };
+
+    QString m_fileName;
+    QVector<Rule> m_rules;
+    double m_inputs[Expression::VariableCount];
+    History m_history[Telemetry::SourceCount];
+};
+}
+
+#endif
@@ -0,0 +1,585 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Timeline.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QFileDialog>
+#include <QStringList>
+#include <QRegExp>
+#include <QCoreApplication>
+
+#include <algorithm>
+
+#include <Logger.h>
+#include <Misc/Utilities.h>
+#include <Misc/TimerEvents.h>
+#include <SerialStudio/Communicator.h>
+
+using namespace Mission;
+
+/*
+ * Conversion factors for the monotonic clock
+ */
+#define NSECS_PER_MSEC 1000000
+#define NSECS_PER_SEC  1000000000
+
+/*
+ * Time (in ns) before an entry is due at which the scheduler stops sleeping & starts
+ * polling the clock, it covers the wake-up latency of the precise timer
+ */
+#define SPIN_WINDOW 2000000
+
+/*
+ * Pointer to singleton instance of class
+ */
+static Timeline *INSTANCE = nullptr;
+
+/**
+ * Returns the time (in ns) of the timer module, which follows virtual time
+ */
+static qint64 monotonicTime()
+{
+    return Misc::TimerEvents::getInstance()->nsecsElapsed();
+}
+
+/**
+ * Constructor function, the timer is a child of the scheduler so that it is moved to
+ * the scheduler thread together with it
+ */
+TimelineScheduler::TimelineScheduler()
+    : m_timer(new QTimer(this))
+    , m_deadline(0)
+{
+    m_clock.start();
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &TimelineScheduler::onTimeout);
+}
+
+/**
+ * Stops waiting for the current entry
+ */
+void TimelineScheduler::cancel()
+{
+    m_timer->stop();
+}
+
+/**
+ * Emits the due() signal once @a delay nanoseconds have elapsed. The timer is started
+ * so that it expires @c SPIN_WINDOW before the deadline, any previous deadline is
+ * replaced.
+ */
+void TimelineScheduler::schedule(const qint64 delay)
+{
+    m_deadline = m_clock.nsecsElapsed() + delay;
+    const auto sleep = (delay - SPIN_WINDOW) / NSECS_PER_MSEC;
+    m_timer->start(static_cast<int>(qMax<qint64>(0, sleep)));
+}
+
+/**
+ * Polls the clock until the deadline is reached & emits the due() signal. The spin is
+ * bounded to twice the @c SPIN_WINDOW, if the timer expired earlier than that (which
+ * happens with coarse system timers) the scheduler sleeps again.
+ */
+void TimelineScheduler::onTimeout()
+{
+    const auto remaining = m_deadline - m_clock.nsecsElapsed();
+    if (remaining > 2 * SPIN_WINDOW)
+    {
+        m_timer->start(static_cast<int>((remaining - SPIN_WINDOW) / NSECS_PER_MSEC));
+        return;
+    }
+
+    while (m_clock.nsecsElapsed() < m_deadline)
+        continue;
+
+    emit due();
+}
+
+/**
+ * Constructor function
+ */
+Timeline::Timeline()
+    : m_next(0)
+    , m_running(false)
+    , m_scheduled(false)
+    , m_zeroTime(0)
+    , m_scheduler(new TimelineScheduler)
+{
+    // Run the scheduler in its own thread
+    m_scheduler->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_scheduler, &TimelineScheduler::deleteLater);
+    connect(m_scheduler, &TimelineScheduler::due, this, &Timeline::onSchedulerDue);
+    m_thread.setObjectName("Timeline scheduler");
+    m_thread.start(QThread::TimeCriticalPriority);
+
+    // Stop the scheduler thread before the application exits
+    connect(qApp, &QCoreApplication::aboutToQuit, this, [=] {
+        m_thread.quit();
+        m_thread.wait();
+    });
+
+    auto te = Misc::TimerEvents::getInstance();
+    connect(te, &Misc::TimerEvents::timeout5Hz, this, &Timeline::updateMissionTime);
+    connect(te, &Misc::TimerEvents::timeout42Hz, this, &Timeline::onTimeout42Hz);
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+Timeline *Timeline::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new Timeline;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns the number of timeline entries
+ */
+int Timeline::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_entries.count();
+}
+
+/**
+ * Returns the data of the timeline entry at the given @a index
+ */
+QVariant Timeline::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.count())
+        return QVariant();
+
+    const auto &entry = m_entries.at(index.row());
+    switch (role)
+    {
+        case OffsetRole:
+            return QString("T%1%2 s")
+                .arg(entry.offset < 0 ? "-" : "+")
+                .arg(qAbs(entry.offset) / static_cast<double>(NSECS_PER_SEC), 0, 'f', 3);
+        case DescriptionRole:
+        case Qt::DisplayRole:
+            return entry.description;
+        case StateRole:
+            return entry.state;
+        case ErrorRole:
+            if (entry.state == Dispatched)
+                return QString("%1 ms").arg(entry.error / 1e6, 0, 'f', 3);
+            return QString();
+    }
+
+    return QVariant();
+}
+
+/**
+ * Returns the role names used by the QML interface
+ */
+QHash<int, QByteArray> Timeline::roleNames() const
+{
+    QHash<int, QByteArray> names;
+    names.insert(OffsetRole, "offset");
+    names.insert(DescriptionRole, "description");
+    names.insert(StateRole, "state");
+    names.insert(ErrorRole, "error");
+    return names;
+}
+
+/**
+ * Returns @c true if the timeline is being executed
+ */
+bool Timeline::running() const
+{
+    return m_running;
+}
+
+/**
+ * Returns the name of the loaded timeline script
+ */
+QString Timeline::fileName() const
+{
+    if (m_fileName.isEmpty())
+        return tr("No timeline loaded");
+
+    return QFileInfo(m_fileName).fileName();
+}
+
+/**
+ * Returns the current mission time (relative to T-0) in T±hh:mm:ss format
+ */
+QString Timeline::missionTime() const
+{
+    if (!m_running)
+        return "T-00:00:00";
+
+    const auto now = monotonicTime();
+    const auto secs = (now - m_zeroTime) / NSECS_PER_SEC;
+    const auto abs = qAbs(secs);
+    return QString("T%1%2:%3:%4")
+        .arg(now < m_zeroTime ? "-" : "+")
+        .arg(abs / 3600, 2, 10, QChar('0'))
+        .arg((abs / 60) % 60, 2, 10, QChar('0'))
+        .arg(abs % 60, 2, 10, QChar('0'));
+}
+
+/**
+ * Reads the timeline script at the given @a path. All the errors of the script are
+ * reported at once & the current timeline is kept if the script is not valid.
+ */
+bool Timeline::load(const QString &path)
+{
+    // Open file
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+    {
+        Misc::Utilities::showMessageBox(tr("File open error"), file.errorString());
+        return false;
+    }
+
+    // Parse each line
+    int lineNumber = 0;
+    QStringList errors;
+    QVector<Entry> entries;
+    QTextStream in(&file);
+    while (!in.atEnd())
+    {
+        // Remove comments & skip empty lines
+        ++lineNumber;
+        auto line = in.readLine();
+        line = line.left(line.indexOf('#')).trimmed();
+        if (line.isEmpty())
+            continue;
+
+        // Get offset, action & argument
+        auto tokens = line.split(QRegExp("\\s+"));
+        auto offset = tokens.at(0).toUpper();
+        auto action = tokens.value(1).toUpper();
+        auto argument = tokens.value(2).toUpper();
+
+        // Parse offset
+        bool ok = false;
+        if (offset.startsWith('T'))
+            offset.remove(0, 1);
+        const double seconds = offset.toDouble(&ok);
+        if (!ok)
+        {
+            errors.append(
+                tr("Line %1: invalid time \"%2\"").arg(lineNumber).arg(tokens.at(0)));
+            continue;
+        }
+
+        // Parse action
+        Entry entry;
+        entry.error = 0;
+        entry.enabled = true;
+        entry.state = Waiting;
+        entry.offset = static_cast<qint64>(seconds * NSECS_PER_SEC);
+        entry.description = tokens.mid(1).join(' ');
+        if (action == "SYNC_TIME")
+            entry.action = SyncTime;
+        else if (action == "RELEASE_SP1")
+            entry.action = ReleasePayload1;
+        else if (action == "RELEASE_SP2")
+            entry.action = ReleasePayload2;
+        else if (action == "CONTAINER_TELEMETRY")
+            entry.action = ContainerTelemetry;
+        else if (action == "SP1_TELEMETRY")
+            entry.action = Payload1Telemetry;
+        else if (action == "SP2_TELEMETRY")
+            entry.action = Payload2Telemetry;
+        else if (action == "SIMULATION" && argument == "ACTIVATE")
+            entry.action = SimulationActivate;
+        else if (action == "SIMULATION")
+            entry.action = SimulationMode;
+        else
+        {
+            errors.append(
+                tr("Line %1: unknown action \"%2\"").arg(lineNumber).arg(action));
+            continue;
+        }
+
+        // Parse ON/OFF argument
+        if (entry.action != SyncTime && entry.action != ReleasePayload1
+            && entry.action != ReleasePayload2 && entry.action != SimulationActivate)
+        {
+            if (argument == "ON" || argument == "ENABLE")
+                entry.enabled = true;
+            else if (argument == "OFF" || argument == "DISABLE")
+                entry.enabled = false;
+            else
+            {
+                errors.append(tr("Line %1: expected ON or OFF").arg(lineNumber));
+                continue;
+            }
+        }
+
+        // Register entry
+        entries.append(entry);
+    }
+
+    // Report errors
+    if (!errors.isEmpty())
+    {
+        Misc::Utilities::showMessageBox(tr("Invalid timeline script"), errors.join("\n"));
+        return false;
+    }
+
+    // Sort entries by time (keeping the script order for simultaneous entries)
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.offset < b.offset;
+    });
+
+    // Replace current timeline
+    stop();
+    beginResetModel();
+    m_entries = entries;
+    m_fileName = path;
+    endResetModel();
+
+    // Update UI
+    LOG_INFO() << "Loaded timeline" << path << "with" << entries.count() << "entries";
+    emit loaded();
+    return true;
+}
+
+/**
+ * Stops executing the timeline
+ */
+void Timeline::stop()
+{
+    if (m_running)
+    {
+        m_running = false;
+        m_scheduled = false;
+        QMetaObject::invokeMethod(m_scheduler, "cancel", Qt::QueuedConnection);
+        LOG_INFO() << "Timeline stopped";
+
+        emit runningChanged();
+        emit missionTimeChanged();
+    }
+}
+
+/**
+ * Starts executing the timeline. T-0 is set so that the first entry is executed
+ * immediately if it has a negative offset.
+ */
+void Timeline::start()
+{
+    // Nothing to do
+    if (m_entries.isEmpty())
+        return;
+
+    // Stop current run
+    stop();
+
+    // Reset entries
+    for (int i = 0; i < m_entries.count(); ++i)
+    {
+        m_entries[i].error = 0;
+        m_entries[i].state = Waiting;
+    }
+    emit dataChanged(index(0), index(m_entries.count() - 1));
+
+    // Set T-0 & start scheduler
+    m_next = 0;
+    m_running = true;
+    const auto delay = qMax<qint64>(0, -m_entries.first().offset);
+    m_zeroTime = monotonicTime() + delay;
+    LOG_INFO() << "Timeline started, T-0 in" << delay / NSECS_PER_MSEC << "ms";
+
+    emit runningChanged();
+    scheduleNext();
+}
+
+/**
+ * Lets the user select a timeline script
+ */
+void Timeline::openScript()
+{
+    // clang-format off
+    auto name = QFileDialog::getOpenFileName(Q_NULLPTR,
+                                             tr("Select timeline script"),
+                                             QDir::homePath());
+    // clang-format on
+
+    if (!name.isEmpty())
+        load(name);
+}
+
+/**
+ * Dispatches the entries that are due in virtual time mode, where the scheduler thread
+ * is not used because virtual time runs faster than the wall clock. The scheduler is
+ * started again if virtual time mode was disabled during the run.
+ */
+void Timeline::onTimeout42Hz()
+{
+    if (Misc::TimerEvents::getInstance()->virtualTime())
+        dispatchDueEntries();
+
+    else if (m_running && !m_scheduled)
+        scheduleNext();
+}
+
+/**
+ * Called when the scheduler thread reports that the next entry is due
+ */
+void Timeline::onSchedulerDue()
+{
+    m_scheduled = false;
+    dispatchDueEntries();
+}
+
+/**
+ * Dispatches all the entries whose time has been reached
+ */
+void Timeline::dispatchDueEntries()
+{
+    if (!m_running || m_next >= m_entries.count())
+        return;
+
+    // Scheduler woke us up too early, sleep again
+    const auto target = m_zeroTime + m_entries.at(m_next).offset;
+    if (monotonicTime() < target)
+    {
+        scheduleNext();
+        return;
+    }
+
+    // Dispatch all due entries
+    while (m_next < m_entries.count()
+           && monotonicTime() >= m_zeroTime + m_entries.at(m_next).offset)
+    {
+        dispatch(m_next);
+        ++m_next;
+    }
+
+    // Schedule next entry
+    scheduleNext();
+}
+
+/**
+ * Updates the mission time displayed by the user interface
+ */
+void Timeline::updateMissionTime()
+{
+    if (m_running)
+        emit missionTimeChanged();
+}
+
+/**
+ * Asks the scheduler thread to wake the timeline when the next entry is due, or stops
+ * the timeline if all entries have been dispatched.
+ */
+void Timeline::scheduleNext()
+{
+    if (m_next >= m_entries.count())
+    {
+        LOG_INFO() << "Timeline finished";
+        stop();
+        return;
+    }
+
+    // Virtual time mode, entries are dispatched by the 42 Hz signal
+    if (Misc::TimerEvents::getInstance()->virtualTime())
+        return;
+
+    // Wake up when the next entry is due
+    const auto target = m_zeroTime + m_entries.at(m_next).offset;
+    const auto delay = qMax<qint64>(0, target - monotonicTime());
+    QMetaObject::invokeMethod(m_scheduler, "schedule", Qt::QueuedConnection,
+                              Q_ARG(qint64, delay));
+    m_scheduled = true;
+}
+
+/**
+ * Executes the action of the entry at the given @a row & logs the dispatch error. The
+ * entry is marked as failed if the communicator did not send the command.
+ */
+void Timeline::dispatch(const int row)
+{
+    // Register actual dispatch time
+    auto &entry = m_entries[row];
+    const auto actual = monotonicTime();
+    entry.error = actual - (m_zeroTime + entry.offset);
+
+    // Execute action
+    auto communicator = SerialStudio::Communicator::getInstance();
+    if (communicator->connectedToSerialStudio())
+    {
+        bool sent = false;
+        switch (entry.action)
+        {
+            case SyncTime:
+                sent = communicator->updateContainerTime();
+                break;
+            case ReleasePayload1:
+                sent = communicator->releasePayload1();
+                break;
+            case ReleasePayload2:
+                sent = communicator->releasePayload2();
+                break;
+            case ContainerTelemetry:
+                sent = communicator->setContainerTelemetryEnabled(entry.enabled);
+                break;
+            case Payload1Telemetry:
+                sent = communicator->setPayload1TelemetryEnabled(entry.enabled);
+                break;
+            case Payload2Telemetry:
+                sent = communicator->setPayload2TelemetryEnabled(entry.enabled);
+                break;
+            case SimulationMode:
+                sent = communicator->setSimulationMode(entry.enabled);
+                break;
+            case SimulationActivate:
+                sent = communicator->setSimulationActivated(true);
+                break;
+        }
+
+        entry.state = sent ? Dispatched : Failed;
+    }
+
+    // Link is down, skip entry
+    else
+        entry.state = Skipped;
+
+    // Log intended vs. actual time
+    const char *note = "";
+    if (entry.state == Skipped)
+        note = "(skipped, no link)";
+    else if (entry.state == Failed)
+        note = "(failed, command rejected)";
+
+    LOG_INFO() << "Timeline" << entry.description << "intended"
+               << entry.offset / static_cast<double>(NSECS_PER_SEC) << "s, actual"
+               << (actual - m_zeroTime) / static_cast<double>(NSECS_PER_SEC)
+               << "s, error" << entry.error / 1000.0 << "us" << note;
+
+    // Update UI
+    emit dataChanged(index(row), index(row));
+}
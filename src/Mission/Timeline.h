@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISSION_TIMELINE_H
+#define MISSION_TIMELINE_H
+
+#include <QTimer>
+#include <QThread>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QAbstractListModel>
+
+namespace Mission
+{
+/**
+ * Wakes the @c Timeline when its next entry is due. Lives in its own thread: a precise
+ * timer sleeps until shortly before the entry is due & the last couple of milliseconds
+ * are spent polling the monotonic clock, so that the GUI thread is notified with
+ * sub-millisecond accuracy without being blocked by the spin.
+ */
+class TimelineScheduler : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void due();
+
+public:
+    TimelineScheduler();
+
+public slots:
+    void cancel();
+    void schedule(const qint64 delay);
+
+private slots:
+    void onTimeout();
+
+private:
+    QTimer *m_timer;
+    qint64 m_deadline;
+    QElapsedTimer m_clock;
+};
+
+/**
+ * Dispatches a scripted sequence of commands relative to a launch time (T-0). Each line
+ * of a timeline script contains a time offset in seconds & an action, for example:
+ *
+ *     # Sync time a minute before launch, release SP1 at T+45.5 s
+ *     T-60    SYNC_TIME
+ *     T-55    CONTAINER_TELEMETRY ON
+ *     T+45.5  RELEASE_SP1
+ *
+ * A scheduler thread wakes the timeline when each entry is due, so commands are
+ * dispatched within a fraction of a millisecond of their time without keeping the GUI
+ * thread busy. The intended & actual dispatch times are logged, entries whose command
+ * was rejected (e.g. because a command is already pending) are marked as failed. In
+ * virtual time mode, due entries are dispatched by the 42 Hz signal of the timer module
+ * instead.
+ */
+class Timeline : public QAbstractListModel
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool running
+               READ running
+               NOTIFY runningChanged)
+    Q_PROPERTY(QString fileName
+               READ fileName
+               NOTIFY loaded)
+    Q_PROPERTY(QString missionTime
+               READ missionTime
+               NOTIFY missionTimeChanged)
+    // clang-format on
+
+signals:
+    void loaded();
+    void runningChanged();
+    void missionTimeChanged();
+
+public:
+    enum Action
+    {
+        SyncTime,
+        ReleasePayload1,
+        ReleasePayload2,
+        ContainerTelemetry,
+        Payload1Telemetry,
+        Payload2Telemetry,
+        SimulationMode,
+        SimulationActivate,
+    };
+
+    enum State
+    {
+        Waiting,
+        Dispatched,
+        Skipped,
+        Failed,
+    };
+    Q_ENUM(State)
+
+    enum Roles
+    {
+        OffsetRole = Qt::UserRole + 1,
+        DescriptionRole,
+        StateRole,
+        ErrorRole,
+    };
+
+    static Timeline *getInstance();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    bool running() const;
+    QString fileName() const;
+    QString missionTime() const;
+
+    bool load(const QString &path);
+
+public slots:
+    void stop();
+    void start();
+    void openScript();
+
+private slots:
+    void onTimeout42Hz();
+    void onSchedulerDue();
+    void dispatchDueEntries();
+    void updateMissionTime();
+
+private:
+    Timeline();
+    void scheduleNext();
+    void dispatch(const int row);
+
+private:
+    struct Entry
+    {
+        qint64 offset;
+        Action action;
+        bool enabled;
+        QString description;
+        State state;
+        qint64 error;
+    };
+
+    int m_next;
+    bool m_running;
+    bool m_scheduled;
+    qint64 m_zeroTime;
+    QString m_fileName;
+    QThread m_thread;
+    QVector<Entry> m_entries;
+    TimelineScheduler *m_scheduler;
+};
+}
+
+#endif
@@ -0,0 +1,512 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "CommandTracker.h"
+
+#include <QTime>
+#include <QDateTime>
+#include <QSettings>
+#include <Logger.h>
+#include <Misc/Metrics.h>
+#include <Misc/TimerEvents.h>
+#include <SerialStudio/XBee.h>
+
+using namespace SerialStudio;
+
+/*
+ * Maximum number of commands displayed by the user interface
+ */
+#define MAX_HISTORY 100
+
+/*
+ * Default acknowledgement options
+ */
+#define DEFAULT_ACK_TIMEOUT  3000
+#define DEFAULT_MAX_ATTEMPTS 3
+
+/*
+ * Maximum difference (in seconds) between the time sent in a time update & the time
+ * echoed by the container, to account for the time it takes to set the clock
+ */
+#define TIME_TOLERANCE 2
+
+/*
+ * Number of seconds in a day, used to compare time updates around midnight
+ */
+#define SECONDS_PER_DAY 86400
+
+/*
+ * Pointer to singleton instance of class
+ */
+static CommandTracker *INSTANCE = nullptr;
+
+/**
+ * Constructor function
+ */
+CommandTracker::CommandTracker()
+{
+    QSettings settings;
+    settings.beginGroup("CommandTracker");
+    m_ackTimeout = settings.value("ackTimeout", DEFAULT_ACK_TIMEOUT).toInt();
+    m_maxAttempts = settings.value("maxAttempts", DEFAULT_MAX_ATTEMPTS).toInt();
+    settings.endGroup();
+
+    auto te = Misc::TimerEvents::getInstance();
+    connect(te, &Misc::TimerEvents::timeout5Hz, this, &CommandTracker::checkTimeouts);
+    connect(this, &CommandTracker::pendingCountChanged, this,
+            &CommandTracker::updateMetrics);
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+CommandTracker *CommandTracker::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new CommandTracker;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns the number of tracked commands
+ */
+int CommandTracker::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_entries.count();
+}
+
+/**
+ * Returns the data of the command at the given @a index
+ */
+QVariant CommandTracker::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.count())
+        return QVariant();
+
+    const auto &entry = m_entries.at(index.row());
+    switch (role)
+    {
+        case CommandRole:
+        case Qt::DisplayRole:
+            return entry.command;
+        case StateRole:
+            return entry.state;
+        case StateNameRole:
+            switch (entry.state)
+            {
+                case Pending:
+                    return tr("Pending");
+                case Acknowledged:
+                    return tr("Acknowledged");
+                case Failed:
+                    return tr("Failed");
+                case Superseded:
+                    return tr("Superseded");
+                case Unconfirmed:
+                    return tr("Sent");
+            }
+            break;
+        case AttemptsRole:
+            return entry.attempts;
+        case RoundTripTimeRole:
+            return entry.roundTripTime;
+        case SentAtRole:
+            return entry.sentAt;
+        case DeliveryRole:
+            return entry.delivery;
+    }
+
+    return QVariant();
+}
+
+/**
+ * Returns the role names used by the QML interface
+ */
+QHash<int, QByteArray> CommandTracker::roleNames() const
+{
+    QHash<int, QByteArray> names;
+    names.insert(CommandRole, "command");
+    names.insert(StateRole, "state");
+    names.insert(StateNameRole, "stateName");
+    names.insert(AttemptsRole, "attempts");
+    names.insert(RoundTripTimeRole, "roundTripTime");
+    names.insert(SentAtRole, "sentAt");
+    names.insert(DeliveryRole, "delivery");
+    return names;
+}
+
+/**
+ * Returns the number of commands that are waiting for an acknowledgement
+ */
+int CommandTracker::pendingCount() const
+{
+    int count = 0;
+    foreach (const auto &entry, m_entries)
+    {
+        if (entry.state == Pending)
+            ++count;
+    }
+
+    return count;
+}
+
+/**
+ * Returns the time (in ms) to wait for the command echo before sending the command again
+ */
+int CommandTracker::ackTimeout() const
+{
+    return m_ackTimeout;
+}
+
+/**
+ * Returns the maximum number of times that a command is sent
+ */
+int CommandTracker::maxAttempts() const
+{
+    return m_maxAttempts;
+}
+
+/**
+ * Registers the given @a command. Returns @c false if the same command is already
+ * waiting for an acknowledgement, in which case the caller must not send it again.
+ *
+ * Pending commands that change the same setting (e.g. "SP1X,ON" & "SP1X,OFF") are
+ * superseded by the new command, so that they are not sent again.
+ */
+bool CommandTracker::track(const QString &command)
+{
+    // Get echo text & changed setting
+    auto key = echoKey(command);
+    auto name = setting(command);
+
+    // Check if command is already pending
+    for (int i = 0; i < m_entries.count(); ++i)
+    {
+        if (m_entries.at(i).state == Pending && m_entries.at(i).key == key)
+            return false;
+    }
+
+    // Replace pending commands that change the same setting
+    for (int i = 0; i < m_entries.count(); ++i)
+    {
+        const auto &entry = m_entries.at(i);
+        if (entry.state == Pending && !name.isEmpty() && entry.setting == name)
+            setState(i, Superseded);
+    }
+
+    // Create entry
+    Entry entry;
+    entry.key = key;
+    entry.setting = name;
+    entry.attempts = 1;
+    entry.command = command;
+    entry.roundTripTime = -1;
+    entry.lastSent = Misc::TimerEvents::getInstance()->elapsed();
+    entry.firstSent = entry.lastSent;
+    entry.sentAt = QDateTime::currentDateTime().toString("hh:mm:ss");
+
+    // The container stops sending telemetry after this command, so we cannot get an echo.
+    // Commands equal to the current echo cannot be confirmed either, since the echo
+    // field would not change.
+    entry.state = Pending;
+    if (key == "CXOFF" || key == m_lastEcho)
+        entry.state = Unconfirmed;
+
+    // Register entry
+    beginInsertRows(QModelIndex(), 0, 0);
+    m_entries.prepend(entry);
+    endInsertRows();
+
+    // Remove old entries
+    if (m_entries.count() > MAX_HISTORY)
+    {
+        beginRemoveRows(QModelIndex(), MAX_HISTORY, m_entries.count() - 1);
+        m_entries.resize(MAX_HISTORY);
+        endRemoveRows();
+    }
+
+    // Update UI
+    emit pendingCountChanged();
+    return true;
+}
+
+/**
+ * Returns the text that the container reports in the CMD_ECHO field after receiving
+ * the given @a command, for example "CMD,1714,CX,ON;" is echoed as "CXON".
+ */
+QString CommandTracker::echoKey(const QString &command)
+{
+    auto fields = command.trimmed().split(',');
+    if (fields.count() < 3)
+        return command;
+
+    QString key;
+    for (int i = 2; i < fields.count(); ++i)
+        key.append(fields.at(i));
+
+    if (key.endsWith(';'))
+        key.chop(1);
+
+    return key;
+}
+
+/**
+ * Returns the name of the setting changed by the given @a command, for example
+ * "CMD,1714,SP1X,ON;" changes "SP1X". Commands that do not change a setting, such as
+ * payload releases, return an empty string.
+ */
+QString CommandTracker::setting(const QString &command)
+{
+    auto fields = command.trimmed().split(',');
+    if (fields.count() < 4)
+        return QString();
+
+    auto name = fields.at(2);
+    auto value = fields.at(3);
+    if (value.endsWith(';'))
+        value.chop(1);
+
+    if (name == "ST")
+        return name;
+
+    if (value == "ON" || value == "OFF" || value == "ENABLE" || value == "DISABLE")
+        return name;
+
+    return QString();
+}
+
+/**
+ * Removes all the commands that are not waiting for an acknowledgement
+ */
+void CommandTracker::clear()
+{
+    beginResetModel();
+    QVector<Entry> pending;
+    foreach (const auto &entry, m_entries)
+    {
+        if (entry.state == Pending)
+            pending.append(entry);
+    }
+    m_entries = pending;
+    endResetModel();
+}
+
+/**
+ * Re-sends the commands that were not acknowledged within the configured timeout &
+ * marks them as failed after the maximum number of attempts.
+ */
+void CommandTracker::checkTimeouts()
+{
+    const auto now = Misc::TimerEvents::getInstance()->elapsed();
+    for (int i = m_entries.count() - 1; i >= 0; --i)
+    {
+        auto &entry = m_entries[i];
+        if (entry.state != Pending || now - entry.lastSent < m_ackTimeout)
+            continue;
+
+        if (entry.attempts >= m_maxAttempts)
+        {
+            LOG_WARNING() << "Command" << entry.command << "not acknowledged after"
+                          << entry.attempts << "attempts";
+            setState(i, Failed);
+            continue;
+        }
+
+        ++entry.attempts;
+        entry.lastSent = now;
+        LOG_INFO() << "Retrying command" << entry.command << "attempt" << entry.attempts;
+        updateRow(i);
+        emit retryRequested(entry.command);
+    }
+}
+
+/**
+ * Changes the acknowledgement @a timeout (in ms)
+ */
+void CommandTracker::setAckTimeout(const int timeout)
+{
+    if (timeout > 0 && timeout != m_ackTimeout)
+    {
+        m_ackTimeout = timeout;
+        QSettings().setValue("CommandTracker/ackTimeout", timeout);
+        emit configurationChanged();
+    }
+}
+
+/**
+ * Changes the maximum number of times that a command is sent
+ */
+void CommandTracker::setMaxAttempts(const int attempts)
+{
+    if (attempts > 0 && attempts != m_maxAttempts)
+    {
+        m_maxAttempts = attempts;
+        QSettings().setValue("CommandTracker/maxAttempts", attempts);
+        emit configurationChanged();
+    }
+}
+
+/**
+ * Acknowledges the oldest pending command that matches the CMD_ECHO field of the
+ * latest container packet.
+ *
+ * The container repeats the last echo in every packet, so only echoes that changed
+ * acknowledge a command. Every pending command was sent before the change is received,
+ * while a stale echo that is repeated after a new command was sent is ignored.
+ */
+void CommandTracker::processEcho(const QByteArray &echo)
+{
+    // Get echo string
+    auto key = QString::fromUtf8(echo.trimmed());
+    if (key.isEmpty())
+        return;
+
+    // Ignore repeated echoes
+    if (key == m_lastEcho)
+        return;
+
+    // Register echo change
+    m_lastEcho = key;
+
+    // Find oldest matching command
+    int row = -1;
+    for (int i = m_entries.count() - 1; i >= 0; --i)
+    {
+        const auto &entry = m_entries.at(i);
+        if (entry.state != Pending)
+            continue;
+
+        if (matches(entry, key))
+        {
+            row = i;
+            break;
+        }
+    }
+
+    // Acknowledge command
+    if (row >= 0)
+    {
+        auto &entry = m_entries[row];
+        const auto now = Misc::TimerEvents::getInstance()->elapsed();
+        entry.roundTripTime = now - entry.lastSent;
+        LOG_INFO() << "Command" << entry.command << "acknowledged in"
+                   << entry.roundTripTime << "ms";
+        setState(row, Acknowledged);
+    }
+}
+
+/**
+ * Registers the delivery report of the XBee radio for the latest transmission of the
+ * given @a command. Time updates are matched with a tolerance, since retries are sent
+ * with the current time.
+ */
+void CommandTracker::processTransmitStatus(const QString &command, const quint8 status,
+                                           const quint8 retries)
+{
+    // Log failed deliveries, including frames that are not tracked (e.g. SIMP)
+    const auto name = XBeeDecoder::statusName(status);
+    if (status != 0)
+        LOG_WARNING() << "Radio could not deliver" << command << name;
+
+    // Find latest matching command
+    const auto key = echoKey(command);
+    for (int i = 0; i < m_entries.count(); ++i)
+    {
+        auto &entry = m_entries[i];
+        if (matches(entry, key))
+        {
+            entry.delivery = name;
+            if (retries > 0)
+                entry.delivery.append(tr(" (%1 retries)").arg(retries));
+
+            updateRow(i);
+            return;
+        }
+    }
+}
+
+/**
+ * Returns @c true if the given echo @a key corresponds to the given command @a entry.
+ *
+ * Time updates are matched by their time value, the container may echo the time it
+ * actually set & retries are sent with the current time. The echoed time must lie
+ * between the time sent originally & the time of the latest retry, with a tolerance
+ * of @c TIME_TOLERANCE seconds.
+ */
+bool CommandTracker::matches(const Entry &entry, const QString &key) const
+{
+    // Compare commands directly
+    if (entry.key == key)
+        return true;
+
+    // Only time updates are matched with a tolerance
+    if (entry.setting != "ST" || !key.startsWith("ST"))
+        return false;
+
+    // Get time values
+    const auto sent = QTime::fromString(entry.key.mid(2), "hh:mm:ss");
+    const auto echoed = QTime::fromString(key.mid(2), "hh:mm:ss");
+    if (!sent.isValid() || !echoed.isValid())
+        return false;
+
+    // Get difference between both times, handling midnight
+    auto diff = sent.secsTo(echoed);
+    if (diff < -SECONDS_PER_DAY / 2)
+        diff += SECONDS_PER_DAY;
+    else if (diff > SECONDS_PER_DAY / 2)
+        diff -= SECONDS_PER_DAY;
+
+    // Check that echoed time lies within the send window of the command
+    const auto window = (entry.lastSent - entry.firstSent) / 1000;
+    return diff >= -TIME_TOLERANCE && diff <= window + TIME_TOLERANCE;
+}
+
+/**
+ * Exports the number of pending commands to the metrics endpoint
+ */
+void CommandTracker::updateMetrics()
+{
+    Misc::Metrics::set(Misc::Metrics::PendingCommands, pendingCount());
+}
+
+/**
+ * Notifies the UI that the command at the given @a row changed
+ */
+void CommandTracker::updateRow(const int row)
+{
+    auto modelIndex = index(row);
+    emit dataChanged(modelIndex, modelIndex);
+}
+
+/**
+ * Changes the @a state of the command at the given @a row & updates the UI
+ */
+void CommandTracker::setState(const int row, const State state)
+{
+    m_entries[row].state = state;
+    updateRow(row);
+    emit pendingCountChanged();
+}
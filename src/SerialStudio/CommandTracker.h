@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIALSTUDIO_COMMAND_TRACKER_H
+#define SERIALSTUDIO_COMMAND_TRACKER_H
+
+#include <QVector>
+#include <QAbstractListModel>
+
+namespace SerialStudio
+{
+/**
+ * Keeps track of the commands sent to the CanSat until the container reports them in
+ * the CMD_ECHO field of its telemetry. Commands that are not acknowledged within the
+ * configured timeout are sent again, up to a maximum number of attempts. Timeouts follow
+ * the clock of the timer module, so they also work in virtual time mode.
+ *
+ * When the ground radio is used in XBee API mode, the delivery reports of the radio are
+ * also registered, so that the user can tell a lost frame from a missing echo.
+ *
+ * The class is also a list model, so that the QML interface can display the state &
+ * round-trip time of the latest commands.
+ */
+class CommandTracker : public QAbstractListModel
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int pendingCount
+               READ pendingCount
+               NOTIFY pendingCountChanged)
+    Q_PROPERTY(int ackTimeout
+               READ ackTimeout
+               WRITE setAckTimeout
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int maxAttempts
+               READ maxAttempts
+               WRITE setMaxAttempts
+               NOTIFY configurationChanged)
+    // clang-format on
+
+signals:
+    void pendingCountChanged();
+    void configurationChanged();
+    void retryRequested(const QString &command);
+
+public:
+    enum State
+    {
+        Pending,
+        Acknowledged,
+        Failed,
+        Superseded,
+        Unconfirmed,
+    };
+    Q_ENUM(State)
+
+    enum Roles
+    {
+        CommandRole = Qt::UserRole + 1,
+        StateRole,
+        StateNameRole,
+        AttemptsRole,
+        RoundTripTimeRole,
+        SentAtRole,
+        DeliveryRole,
+    };
+
+    static CommandTracker *getInstance();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int pendingCount() const;
+    int ackTimeout() const;
+    int maxAttempts() const;
+
+    bool track(const QString &command);
+    static QString echoKey(const QString &command);
+    static QString setting(const QString &command);
+
+public slots:
+    void clear();
+    void checkTimeouts();
+    void setAckTimeout(const int timeout);
+    void setMaxAttempts(const int attempts);
+    void processEcho(const QByteArray &echo);
+    void processTransmitStatus(const QString &command, const quint8 status,
+                               const quint8 retries);
+
+private slots:
+    void updateMetrics();
+
+private:
+    CommandTracker();
+    void updateRow(const int row);
+    void setState(const int row, const State state);
+
+private:
+    struct Entry
+    {
+        QString command;
+        QString key;
+        QString setting;
+        QString sentAt;
+        QString delivery;
+        State state;
+        int attempts;
+        qint64 firstSent;
+        qint64 lastSent;
+        qint64 roundTripTime;
+    };
+
+    bool matches(const Entry &entry, const QString &key) const;
+
+private:
+    int m_ackTimeout;
+    int m_maxAttempts;
+    QString m_lastEcho;
+    QVector<Entry> m_entries;
+};
+}
+
+#endif
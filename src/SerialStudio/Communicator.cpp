@@ -23,24 +23,36 @@
 #include "Communicator.h"
 
 #include <QDir>
-#include <QFileInfo>
 #include <QJsonArray>
+#include <QGuiApplication>
 #include <QFileDialog>
 #include <QJsonObject>
-#include <QHostAddress>
 #include <QJsonDocument>
+#include <QSettings>
 
-#include <qtcsv/reader.h>
+#include <Logger.h>
 #include <Misc/Utilities.h>
 #include <Misc/TimerEvents.h>
+#include <Misc/Metrics.h>
+#include <Misc/Profiler.h>
+#include <Misc/StartupTrace.h>
+#include <SerialStudio/StressTest.h>
+#include <SerialStudio/CommandTracker.h>
 
 using namespace SerialStudio;
 
 /*
- * Set TCP port to communicate with Serial Studio
+ * Default TCP endpoint to communicate with Serial Studio
  */
+#define SERIAL_STUDIO_PLUGINS_HOST "127.0.0.1"
 #define SERIAL_STUDIO_PLUGINS_PORT 7777
 
+/*
+ * Minimum wall-clock time (in ms) between two reconnection attempts, a bit shorter than
+ * the period of the 5 Hz signal so that no real-time attempt is skipped
+ */
+#define RECONNECT_INTERVAL 150
+
 /*
  * Pointer to singleton instance of class
  */
@@ -53,25 +65,68 @@ Communicator::Communicator()
 {
     // Set default values
     m_row = 0;
+    m_lastTick = -1;
+    m_profileLoop = false;
+    m_stressMode = StressTest::requested();
     m_currentTime = "";
+    m_clockPaused = false;
     m_currentSimulationData = "";
     m_simulationEnabled = false;
     m_simulationActivated = false;
     m_payload1TelemetryEnabled = true;
     m_payload2TelemetryEnabled = true;
     m_containerTelemetryEnabled = false;
-
-    // Connect socket signals/slots
-    connect(&m_socket, &QTcpSocket::disconnected, &m_socket, &QTcpSocket::close);
-    connect(&m_socket, &QTcpSocket::connected, this, &Communicator::onConnectedChanged);
-    connect(&m_socket, &QTcpSocket::disconnected, this,
-            &Communicator::onConnectedChanged);
+    m_duplicatePackets = 0;
+    m_dirtyFields = 0;
+    m_frameId = 0;
+    qRegisterMetaType<SerialStudio::State>();
+    markDirty(State::AllFields);
+
+    // Load clock precision, we only refresh the clock as often as its format requires.
+    // Tenths of a second are shown by default, milliseconds only while the application
+    // has the focus.
+    auto precision = QSettings().value("Clock/precision", Tenths).toInt();
+    m_clockPrecision = static_cast<ClockPrecision>(qBound(0, precision, 2));
+    m_clockTimer.setSingleShot(true);
+    m_clockTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_clockTimer, &QTimer::timeout, this, &Communicator::updateCurrentTime);
+    connect(qApp, &QGuiApplication::applicationStateChanged, this, [=] {
+        if (!m_clockPaused)
+            updateCurrentTime();
+    });
+    updateCurrentTime();
+
+    // Load XBee API mode configuration, commands are always addressed to the container
+    auto xbee = XBeeSettings::load();
+    m_xbeeEncoder = XBeeEncoder(xbee.escaped);
+    m_xbeeDestination = xbee.containerAddress;
+
+    // Load Serial Studio endpoints, use local instance by default
+    QSettings settings;
+    const int count = settings.beginReadArray("Links");
+    for (int i = 0; i < count; ++i)
+    {
+        settings.setArrayIndex(i);
+        auto host = settings.value("host").toString();
+        auto port = settings.value("port").toUInt();
+        auto type = Transport::typeFromName(settings.value("transport").toString());
+        if (!host.isEmpty() && port > 0 && port <= 0xFFFF)
+            registerLink(host, static_cast<quint16>(port), type);
+    }
+    settings.endArray();
+    if (m_links.isEmpty())
+        registerLink(SERIAL_STUDIO_PLUGINS_HOST, SERIAL_STUDIO_PLUGINS_PORT,
+                     Transport::Type::Tcp);
 
     // Timer module signals/slots
     auto te = Misc::TimerEvents::getInstance();
-    connect(te, &Misc::TimerEvents::timeout5Hz, this, &Communicator::tryConnection);
+    connect(te, &Misc::TimerEvents::timeout5Hz, this, &Communicator::reconnectLinks);
     connect(te, &Misc::TimerEvents::timeout1Hz, this, &Communicator::sendSimulatedData);
-    connect(te, &Misc::TimerEvents::timeout42Hz, this, &Communicator::updateCurrentTime);
+
+    // Re-send commands that were not acknowledged by the container
+    auto tracker = CommandTracker::getInstance();
+    connect(tracker, &CommandTracker::retryRequested, this,
+            &Communicator::onRetryRequested);
 }
 
 /**
@@ -86,11 +141,26 @@ Communicator *Communicator::getInstance()
 }
 
 /**
- * Returns @c true if the application is connected to the Serial Studio TCP server
+ * Returns the last published snapshot of the communicator state
+ */
+State Communicator::state() const
+{
+    return m_state;
+}
+
+/**
+ * Returns @c true if the application is connected to at least one Serial Studio
+ * TCP server
  */
 bool Communicator::connectedToSerialStudio() const
 {
-    return m_socket.state() == QTcpSocket::ConnectedState;
+    foreach (auto link, m_links)
+    {
+        if (link->connected())
+            return true;
+    }
+
+    return false;
 }
 
 /**
@@ -141,16 +211,29 @@ QString Communicator::currentTime() const
     return m_currentTime;
 }
 
+/**
+ * Returns @c true if the clock is not being updated because the window is not visible
+ */
+bool Communicator::clockPaused() const
+{
+    return m_clockPaused;
+}
+
+/**
+ * Returns the precision with which the clock is displayed & updated
+ */
+Communicator::ClockPrecision Communicator::clockPrecision() const
+{
+    return m_clockPrecision;
+}
+
 /**
  * Returns the name of the currently loaded CSV file
  */
 QString Communicator::csvFileName() const
 {
-    if (m_file.isOpen())
-    {
-        auto fileInfo = QFileInfo(m_file.fileName());
-        return fileInfo.fileName();
-    }
+    if (m_profile)
+        return m_profile->name;
 
     return tr("No CSV file selected");
 }
@@ -164,8 +247,134 @@ QString Communicator::currentSimulatedReading() const
 }
 
 /**
- * Opens a dialog that allows the user to select a CSV file to load to the application.
- * The CSV file must contain only one column with simulated pressure data.
+ * Returns the validation report of the loaded pressure profile
+ */
+QString Communicator::profileReport() const
+{
+    if (!m_profile)
+        return "";
+
+    return m_profile->report;
+}
+
+/**
+ * Returns a list with the Serial Studio links, used by the QML interface to display the
+ * health of each link
+ */
+QVariantList Communicator::links() const
+{
+    QVariantList list;
+    foreach (auto link, m_links)
+        list.append(QVariant::fromValue(link));
+
+    return list;
+}
+
+/**
+ * Returns the number of telemetry packets that were discarded because they had already
+ * been received through another link
+ */
+quint64 Communicator::duplicatePackets() const
+{
+    return m_duplicatePackets;
+}
+
+/**
+ * Returns the names of the transports that can be used to communicate with Serial Studio
+ */
+QStringList Communicator::availableTransports() const
+{
+    return Transport::availableTypes();
+}
+
+/**
+ * Registers a new Serial Studio endpoint & saves the link list. Returns @c false if
+ * the endpoint is invalid or already registered.
+ */
+bool Communicator::addLink(const QString &host, const int port, const QString &transport)
+{
+    // Validate endpoint
+    auto address = host.trimmed();
+    if (address.isEmpty() || port <= 0 || port > 0xFFFF)
+        return false;
+
+    // Avoid duplicate links
+    auto type = Transport::typeFromName(transport);
+    foreach (auto link, m_links)
+    {
+        if (link->host() == address && link->port() == port
+            && link->transportType() == type)
+            return false;
+    }
+
+    // Register link & try to connect to it
+    registerLink(address, static_cast<quint16>(port), type);
+    m_links.last()->tryConnection();
+    saveLinks();
+    return true;
+}
+
+/**
+ * Closes & removes the link at the given @a index
+ */
+void Communicator::removeLink(const int index)
+{
+    if (index >= 0 && index < m_links.count())
+    {
+        auto link = m_links.takeAt(index);
+        link->close();
+        link->deleteLater();
+
+        saveLinks();
+        onConnectedChanged();
+    }
+}
+
+/**
+ * Closes all the links & replaces them with a single link to the given endpoint. The
+ * new link list is not saved, the stress test uses it to send all the frames to its
+ * local sink.
+ */
+void Communicator::replaceLinks(const QString &host, const quint16 port,
+                                const Transport::Type transport)
+{
+    foreach (auto link, m_links)
+    {
+        link->close();
+        link->deleteLater();
+    }
+
+    m_links.clear();
+    registerLink(host, port, transport);
+    emit linksChanged();
+    onConnectedChanged();
+}
+
+/**
+ * Sends the given stress test @a frame to the links without registering it in the
+ * command tracker, so that every frame of a command burst reaches the sink exactly
+ * once. Frames are rejected unless the application runs in stress mode.
+ */
+bool Communicator::sendStressFrame(const QString &frame)
+{
+    if (!m_stressMode)
+        return false;
+
+    return sendData(frame);
+}
+
+/**
+ * If @a loop is @c true, the simulation restarts from the first row of the profile
+ * when it reaches its end instead of finishing
+ */
+void Communicator::setProfileLoop(const bool loop)
+{
+    m_profileLoop = loop;
+}
+
+/**
+ * Opens a dialog that allows the user to select a CSV file to load to the profile
+ * library & selects the loaded profile.
  */
 void Communicator::openCsv()
 {
@@ -179,208 +388,323 @@ void Communicator::openCsv()
     if (name.isEmpty())
         return;
 
-    // Close current file
-    if (m_file.isOpen())
-        m_file.close();
-
-    // Open the selected file
-    m_file.setFileName(name);
-    if (m_file.open(QFile::ReadOnly))
+    // Load profile, alert user through a messagebox on failure
+    auto library = Mission::ProfileLibrary::getInstance();
+    const int index = library->load(name);
+    if (index < 0)
     {
-        // Close temp. file
-        if (m_tempFile.isOpen())
-            m_tempFile.close();
-
-        // Disable simulation mode
-        if (simulationActivated())
-            setSimulationActivated(false);
-
-        // Generate CSV data
-        QString csv;
-        QTextStream in(&m_file);
-        while (!in.atEnd())
-        {
-            QString line = in.readLine();
-            line.replace(" ", "");
-            if (line.startsWith("#") || line.isEmpty())
-                continue;
-            else
-            {
-                line.replace("$", "1714");
-                csv.append(line);
-                csv.append("\n");
-            }
-        }
+        Misc::Utilities::showMessageBox(tr("File open error"), library->errorString());
+        return;
+    }
 
-        // Save CSV file to temp path
-        m_tempFile.setFileName(QDir::tempPath() + "/cc2021_temp.csv");
-        if (m_tempFile.open(QFile::WriteOnly))
-        {
-            m_tempFile.write(csv.toUtf8());
-            m_tempFile.close();
-        }
+    // Select profile & warn the user if it cannot be simulated
+    selectProfile(index);
+    auto profile = library->profile(index);
+    if (!profile->valid)
+        Misc::Utilities::showMessageBox(tr("Invalid simulation profile"),
+                                        profile->report);
+}
 
-        // Read CSV data
-        if (m_tempFile.open(QFile::ReadOnly))
-        {
-            m_row = 0;
-            m_currentSimulationData = "";
-            m_csvData = QtCSV::Reader::readToList(m_tempFile);
-            emit currentSimulatedReadingChanged();
-        }
+/**
+ * Selects the simulation profile at the given @a index of the profile library.
+ *
+ * If the simulation is not running, the profile is used immediately & the simulation
+ * starts from its first row. Otherwise the profile is handed over at the next 1 Hz
+ * tick & the simulation continues at the same row of the new profile, so that the
+ * simulated mission time is preserved. Invalid profiles cannot replace a running one.
+ */
+void Communicator::selectProfile(const int index)
+{
+    // Get profile
+    auto library = Mission::ProfileLibrary::getInstance();
+    auto profile = library->profile(index);
+    if (!profile)
+        return;
+
+    // Switch profile at the next tick
+    if (simulationActivated())
+    {
+        if (!profile->valid)
+            return;
+
+        m_pendingProfile = profile;
+        LOG_INFO() << "Switching to pressure profile" << profile->name << "at row"
+                   << m_row;
     }
 
-    // Open failure, alert user through a messagebox
+    // Switch profile immediately
     else
-        Misc::Utilities::showMessageBox(tr("File open error"), m_file.errorString());
-
-    // Update UI
-    emit csvFileNameChanged();
+    {
+        m_row = 0;
+        m_profile = profile;
+        m_pendingProfile.reset();
+        m_currentSimulationData = "";
+        library->setActive(m_profile);
+        Misc::Metrics::set(Misc::Metrics::SimulationRow, m_row);
+        markDirty(State::CsvFileName | State::SimulatedReading | State::ProfileReport);
+    }
 }
 
 /**
- * Tries to establish a connection with Serial Studio's TCP server
+ * Tries to establish a connection with all the Serial Studio TCP servers that are not
+ * connected
  */
 void Communicator::tryConnection()
 {
-    if (!connectedToSerialStudio())
-    {
-        m_socket.abort();
-        m_socket.connectToHost(QHostAddress::LocalHost, SERIAL_STUDIO_PLUGINS_PORT);
-    }
+    foreach (auto link, m_links)
+        link->tryConnection();
 }
 
 /**
- * Sends the command to release the first scientific payload
+ * Sends the command to release the first scientific payload.
+ * Returns @c false if the command was not sent.
  */
-void Communicator::releasePayload1()
+bool Communicator::releasePayload1()
 {
     if (connectedToSerialStudio())
-        sendData("CMD,1714,SP,R1;");
+        return sendCommand("CMD,1714,SP,R1;");
+
+    return false;
 }
 
 /**
- * Sends the command to release the second scientific payload
+ * Sends the command to release the second scientific payload.
+ * Returns @c false if the command was not sent.
  */
-void Communicator::releasePayload2()
+bool Communicator::releasePayload2()
 {
     if (connectedToSerialStudio())
-        sendData("CMD,1714,SP,R2;");
+        return sendCommand("CMD,1714,SP,R2;");
+
+    return false;
 }
 
 /**
- * Sends the current time to the payload with the hh:mm:ss format
+ * Sends the current time to the payload with the hh:mm:ss format.
+ * Returns @c false if the command was not sent.
  */
-void Communicator::updateContainerTime()
+bool Communicator::updateContainerTime()
 {
     if (connectedToSerialStudio())
     {
         auto time = QDateTime::currentDateTime().toString("hh:mm:ss");
-        sendData("CMD,1714,ST," + time + ";");
+        return sendCommand("CMD,1714,ST," + time + ";");
     }
+
+    return false;
 }
 
 /**
- * Enables/disables simulation mode
+ * Stops updating the clock while the main window is hidden or minimized
  */
-void Communicator::setSimulationMode(const bool enabled)
+void Communicator::setClockPaused(const bool paused)
 {
-    if (connectedToSerialStudio())
+    if (m_clockPaused != paused)
     {
-        m_simulationActivated = false;
-        m_simulationEnabled = enabled;
-        emit simulationEnabledChanged();
-        emit simulationActivatedChanged();
+        m_clockPaused = paused;
+        emit clockPausedChanged();
+
+        if (paused)
+            m_clockTimer.stop();
+        else
+            updateCurrentTime();
+    }
+}
 
+/**
+ * Changes the clock format & update rate
+ */
+void Communicator::setClockPrecision(const ClockPrecision precision)
+{
+    if (m_clockPrecision != precision)
+    {
+        m_clockPrecision = precision;
+        QSettings().setValue("Clock/precision", precision);
+        emit clockPrecisionChanged();
+
+        if (!m_clockPaused)
+            updateCurrentTime();
+    }
+}
+
+/**
+ * Enables/disables simulation mode.
+ * Returns @c false if the command was not sent.
+ */
+bool Communicator::setSimulationMode(const bool enabled)
+{
+    if (connectedToSerialStudio())
+    {
         QString cmd = "DISABLE";
-        if (simulationEnabled())
+        if (enabled)
             cmd = "ENABLE";
 
-        sendData("CMD,1714,SIM," + cmd + ";");
+        if (!sendCommand("CMD,1714,SIM," + cmd + ";"))
+            return false;
+
+        m_simulationActivated = false;
+        m_simulationEnabled = enabled;
+        markDirty(State::SimulationEnabled | State::SimulationActivated);
+        return true;
     }
+
+    return false;
 }
 
 /**
- * Activates/deactivates sending simulated pressure readings to the CanSat
+ * Activates/deactivates sending simulated pressure readings to the CanSat.
+ * Returns @c false if the command was not sent.
  */
-void Communicator::setSimulationActivated(const bool activated)
+bool Communicator::setSimulationActivated(const bool activated)
 {
     if (connectedToSerialStudio() && simulationEnabled())
     {
         if (activated)
         {
+            // Do not start simulating an invalid profile
+            if (!m_profile || !m_profile->valid)
+            {
+                Misc::Utilities::showMessageBox(tr("Invalid simulation profile"),
+                                                profileReport());
+                return false;
+            }
+
+            if (!sendCommand("CMD,1714,SIM,ACTIVATE;"))
+                return false;
+
             m_simulationActivated = true;
-            emit simulationActivatedChanged();
-            sendData("CMD,1714,SIM,ACTIVATE;");
+            markDirty(State::SimulationActivated);
+            return true;
         }
 
         else
-            setSimulationMode(false);
+            return setSimulationMode(false);
     }
+
+    return false;
 }
 
 /**
- * Enables/disables SP1 telemetry
+ * Enables/disables SP1 telemetry.
+ * Returns @c false if the command was not sent.
  */
-void Communicator::setPayload1TelemetryEnabled(const bool enabled)
+bool Communicator::setPayload1TelemetryEnabled(const bool enabled)
 {
     if (connectedToSerialStudio())
     {
-        m_payload1TelemetryEnabled = enabled;
-        emit payload1TelemetryEnabledChanged();
-
         QString cmd = "OFF";
         if (enabled)
             cmd = "ON";
 
-        sendData("CMD,1714,SP1X," + cmd + ";");
+        if (!sendCommand("CMD,1714,SP1X," + cmd + ";"))
+            return false;
+
+        m_payload1TelemetryEnabled = enabled;
+        markDirty(State::Payload1Telemetry);
+        return true;
     }
+
+    return false;
 }
 
 /**
- * Enables/disables SP2 telemetry
+ * Enables/disables SP2 telemetry.
+ * Returns @c false if the command was not sent.
  */
-void Communicator::setPayload2TelemetryEnabled(const bool enabled)
+bool Communicator::setPayload2TelemetryEnabled(const bool enabled)
 {
     if (connectedToSerialStudio())
     {
-        m_payload2TelemetryEnabled = enabled;
-        emit payload2TelemetryEnabledChanged();
-
         QString cmd = "OFF";
         if (enabled)
             cmd = "ON";
 
-        sendData("CMD,1714,SP2X," + cmd + ";");
+        if (!sendCommand("CMD,1714,SP2X," + cmd + ";"))
+            return false;
+
+        m_payload2TelemetryEnabled = enabled;
+        markDirty(State::Payload2Telemetry);
+        return true;
     }
+
+    return false;
 }
 
 /**
- * Enables/disables container telemetry
+ * Enables/disables container telemetry.
+ * Returns @c false if the command was not sent.
  */
-void Communicator::setContainerTelemetryEnabled(const bool enabled)
+bool Communicator::setContainerTelemetryEnabled(const bool enabled)
 {
     if (connectedToSerialStudio())
     {
-        m_containerTelemetryEnabled = enabled;
-        emit containerTelemetryEnabledChanged();
-
         QString cmd = "OFF";
         if (enabled)
             cmd = "ON";
 
-        sendData("CMD,1714,CX," + cmd + ";");
+        if (!sendCommand("CMD,1714,CX," + cmd + ";"))
+            return false;
+
+        m_containerTelemetryEnabled = enabled;
+        markDirty(State::ContainerTelemetry);
+        return true;
     }
+
+    return false;
 }
 
 /**
- * Gets the current time in hh:mm:ss:zzz format. This value is used by the user interface,
- * not by the CanSat container.
+ * Gets the current time in hh:mm:ss, hh:mm:ss:z or hh:mm:ss:zzz format (depending on
+ * the clock precision). This value is used by the user interface, not by the CanSat
+ * container.
+ *
+ * The next update is scheduled for the moment in which the displayed text changes, so
+ * that the user interface is only repainted when needed. Milliseconds are only shown
+ * while the application is active, otherwise the clock falls back to tenths.
  */
 void Communicator::updateCurrentTime()
 {
-    m_currentTime = QDateTime::currentDateTime().toString("hh:mm:ss:zzz");
-    emit currentTimeChanged();
+    PROFILE_ZONE("Communicator::updateCurrentTime");
+
+    // Show milliseconds only while the user is looking at the application
+    auto precision = m_clockPrecision;
+    if (precision == Milliseconds
+        && QGuiApplication::applicationState() != Qt::ApplicationActive)
+        precision = Tenths;
+
+    // Get update period & time string
+    int period;
+    QString time;
+    auto now = QDateTime::currentDateTime();
+    switch (precision)
+    {
+        case Seconds:
+            period = 1000;
+            time = now.toString("hh:mm:ss");
+            break;
+        case Tenths:
+            period = 100;
+            time = now.toString("hh:mm:ss:") + QString::number(now.time().msec() / 100);
+            break;
+        default:
+            period = 24;
+            time = now.toString("hh:mm:ss:zzz");
+            break;
+    }
+
+    // Update UI only if the text changed
+    if (m_currentTime != time)
+    {
+        m_currentTime = time;
+        emit currentTimeChanged();
+    }
+
+    // Schedule next update at the next period boundary
+    if (!m_clockPaused)
+    {
+        const int msec = now.time().msec();
+        m_clockTimer.start(period - (msec % period) + 1);
+    }
 }
 
 /**
@@ -391,51 +715,84 @@ void Communicator::updateCurrentTime()
  */
 void Communicator::sendSimulatedData()
 {
-    // Stop if simulation mode is not active
-    if (!simulationActivated() || !connectedToSerialStudio())
-        return;
+    PROFILE_ZONE("Communicator::sendSimulatedData");
 
-    // Read, validate & send current row data
-    if (m_row < m_csvData.count() && m_row >= 0)
+    // Measure deviation of the simulation tick from its 1 s period, the stress test
+    // generates the ticks as fast as possible
+    if (!m_stressMode)
     {
-        // Get CSV row data
-        auto row = m_csvData.at(m_row);
-
-        // Generate row string
-        QString cmd = "";
-        for (int i = 0; i < row.count(); ++i)
+        const auto tick = Misc::TimerEvents::getInstance()->nsecsElapsed();
+        if (m_lastTick >= 0)
         {
-            cmd.append(row.at(i));
-            cmd.append(",");
+            const auto deviation = qAbs((tick - m_lastTick) / 1000 - 1000000);
+            Misc::Metrics::set(Misc::Metrics::SimulationTickJitter, deviation);
+            Misc::Metrics::updateMaximum(Misc::Metrics::SimulationTickJitterMax,
+                                         deviation);
         }
+        m_lastTick = tick;
+    }
 
-        // Remove last "," from command string & add ";"
-        cmd.chop(1);
-        cmd.append(";");
+    // Hand over the selected profile at the tick boundary
+    if (m_pendingProfile)
+    {
+        m_profile = m_pendingProfile;
+        m_pendingProfile.reset();
+        Mission::ProfileLibrary::getInstance()->setActive(m_profile);
+        markDirty(State::CsvFileName | State::ProfileReport);
+    }
 
-        // Send command
-        if (!cmd.isEmpty())
-            sendData(cmd);
+    // Stop if simulation mode is not active
+    if (!simulationActivated() || !connectedToSerialStudio())
+        return;
 
-        // Column count invalid
-        else
-            Misc::Utilities::showMessageBox(
-                tr("Simulation CSV error"),
-                tr("Invalid column count at row %1").arg(m_row));
+    // Restart looped profiles
+    if (m_profileLoop && m_profile && m_row >= m_profile->rowCount())
+        m_row = 0;
+
+    // Read & send current row data
+    if (m_profile && m_row < m_profile->rowCount() && m_row >= 0)
+    {
+        // Send command, rows were validated when the profile was loaded
+        const auto cmd = m_profile->command(m_row);
+        sendData(cmd);
+
+        // Show current reading & its barometric altitude
+        m_currentSimulationData = QString("%1  (%2 m)").arg(
+            cmd, QString::number(m_profile->altitudes.at(m_row), 'f', 1));
+        markDirty(State::SimulatedReading);
 
         // Increment row
         ++m_row;
+        Misc::Metrics::set(Misc::Metrics::SimulationRow, m_row);
     }
 
-    // Show CSV finished box & disable simulation mode
+    // Show CSV finished box & disable simulation mode, a modal dialog would block
+    // unattended virtual-time runs
     else
     {
         setSimulationActivated(false);
-        Misc::Utilities::showMessageBox(tr("Pressure simulation finished"),
-                                        tr("Reached end of CSV file"));
+        if (Misc::TimerEvents::getInstance()->virtualTime())
+            LOG_INFO() << "Pressure simulation finished, reached end of CSV file";
+        else
+            Misc::Utilities::showMessageBox(tr("Pressure simulation finished"),
+                                            tr("Reached end of CSV file"));
     }
 }
 
+/**
+ * Tries to re-establish the links that are down. Attempts are paced with the wall
+ * clock, in virtual time mode the 5 Hz signal fires much faster than real time & the
+ * transports would abort connections that are still being established.
+ */
+void Communicator::reconnectLinks()
+{
+    if (m_reconnectClock.isValid() && m_reconnectClock.elapsed() < RECONNECT_INTERVAL)
+        return;
+
+    m_reconnectClock.start();
+    tryConnection();
+}
+
 /**
  * Waits 500 ms and notifies the UI if the TCP connection with Serial Studio has been
  * established.
@@ -445,43 +802,273 @@ void Communicator::sendSimulatedData()
  */
 void Communicator::onConnectedChanged()
 {
-    QTimer::singleShot(500, this, &Communicator::connectedChanged);
+    if (connectedToSerialStudio())
+        Misc::StartupTrace::getInstance()->markOnce("First link connected");
+
+    QTimer::singleShot(500, this, [=] { markDirty(State::Connected); });
+}
+
+/**
+ * Merges the telemetry received from all links. Packets that were already received
+ * through another link are discarded, with a single link every packet is kept.
+ */
+void Communicator::onPacketReceived(const QByteArray &line)
+{
+    // Decode packet
+    auto now = QDateTime::currentMSecsSinceEpoch();
+    auto packet = Telemetry::Packet::fromLine(line, now);
+
+    // Discard duplicated packets, the window is always updated so that it is ready
+    // when another link is added
+    if (packet.isValid())
+    {
+        auto &window = m_sequences[static_cast<int>(packet.source())];
+        const bool fresh = window.accept(packet.packetCount(), now);
+        if (!fresh && m_links.count() > 1)
+        {
+            Misc::Metrics::increment(Misc::Metrics::DuplicatePackets);
+            ++m_duplicatePackets;
+            emit duplicatePacketsChanged();
+            return;
+        }
+    }
+
+    // Register packet
+    Misc::Metrics::increment(Misc::Metrics::TelemetryPackets);
+
+    // Acknowledge commands echoed by the container
+    if (packet.source() == Telemetry::Source::Container)
+    {
+        auto echo = packet.field(Telemetry::ContainerField::CmdEcho);
+        CommandTracker::getInstance()->processEcho(echo);
+    }
+
+    // Update UI & notify other modules
+    {
+        PROFILE_ZONE("QML onRx (RX)");
+        emit rx("RX: " + QString::fromUtf8(line) + "\n");
+    }
+    emit frameReceived(line, now);
+    if (packet.isValid())
+        emit packetReceived(packet);
+}
+
+/**
+ * Sends again a @a command that was not acknowledged by the container. Time updates
+ * are regenerated so that the container does not receive a stale time.
+ */
+void Communicator::onRetryRequested(const QString &command)
+{
+    if (command.startsWith("CMD,1714,ST,"))
+    {
+        auto time = QDateTime::currentDateTime().toString("hh:mm:ss");
+        sendData("CMD,1714,ST," + time + ";");
+    }
+
+    else
+        sendData(command);
+}
+
+/**
+ * Forwards the delivery report of the frame with the given @a frameId to the command
+ * tracker, the frame ID is released so that it can be reused.
+ */
+void Communicator::onTransmitStatusReceived(const quint8 frameId, const quint8 status,
+                                            const quint8 retries)
+{
+    auto &command = m_frameCommands[frameId];
+    if (command.isEmpty())
+        return;
+
+    CommandTracker::getInstance()->processTransmitStatus(command, status, retries);
+    command.clear();
+}
+
+/**
+ * Generates a new snapshot with the fields that were modified since the last snapshot
+ * & notifies the user interface once for all of them.
+ */
+void Communicator::publishState()
+{
+    // Get modified fields
+    const int dirty = m_dirtyFields;
+    m_dirtyFields = 0;
+
+    // Update dirty fields, only keep track of the ones whose value changed
+    State state = m_state;
+    state.m_changedFields = 0;
+    // clang-format off
+    auto update = [&](const int field, bool &member, const bool value) {
+        if ((dirty & field) && member != value) {
+            member = value;
+            state.m_changedFields |= field;
+        }
+    };
+    auto updateText = [&](const int field, QString &member, const QString &value) {
+        if ((dirty & field) && member != value) {
+            member = value;
+            state.m_changedFields |= field;
+        }
+    };
+    // clang-format on
+    update(State::Connected, state.m_connected, connectedToSerialStudio());
+    update(State::SimulationEnabled, state.m_simulationEnabled, simulationEnabled());
+    update(State::SimulationActivated, state.m_simulationActivated,
+           simulationActivated());
+    update(State::Payload1Telemetry, state.m_payload1TelemetryEnabled,
+           payload1TelemetryEnabled());
+    update(State::Payload2Telemetry, state.m_payload2TelemetryEnabled,
+           payload2TelemetryEnabled());
+    update(State::ContainerTelemetry, state.m_containerTelemetryEnabled,
+           containerTelemetryEnabled());
+    updateText(State::CsvFileName, state.m_csvFileName, csvFileName());
+    updateText(State::SimulatedReading, state.m_currentSimulatedReading,
+               currentSimulatedReading());
+    updateText(State::ProfileReport, state.m_profileReport, profileReport());
+
+    // Publish snapshot
+    if (state.m_changedFields != 0)
+    {
+        m_state = state;
+        emit stateChanged();
+    }
+}
+
+/**
+ * Registers that the given state @a fields were modified & schedules the publication
+ * of a new snapshot for the next event loop iteration
+ */
+void Communicator::markDirty(const int fields)
+{
+    if (m_dirtyFields == 0)
+        QMetaObject::invokeMethod(this, "publishState", Qt::QueuedConnection);
+
+    m_dirtyFields |= fields;
+}
+
+/**
+ * Saves the list of Serial Studio endpoints
+ */
+void Communicator::saveLinks()
+{
+    QSettings settings;
+    settings.beginWriteArray("Links", m_links.count());
+    for (int i = 0; i < m_links.count(); ++i)
+    {
+        settings.setArrayIndex(i);
+        settings.setValue("host", m_links.at(i)->host());
+        settings.setValue("port", m_links.at(i)->port());
+        settings.setValue("transport", m_links.at(i)->transport());
+    }
+    settings.endArray();
+
+    emit linksChanged();
+}
+
+/**
+ * Creates a new link to the given Serial Studio endpoint & connects its signals
+ */
+void Communicator::registerLink(const QString &host, const quint16 port,
+                                const Transport::Type transport)
+{
+    auto link = new Link(host, port, transport, this);
+    connect(link, &Link::connectedChanged, this, &Communicator::onConnectedChanged);
+    connect(link, &Link::packetReceived, this, &Communicator::onPacketReceived);
+    connect(link, &Link::transmitStatusReceived, this,
+            &Communicator::onTransmitStatusReceived);
+    m_links.append(link);
 }
 
 /**
- * Displays any socket errors with a message-box
+ * Registers the given @a command in the command tracker & sends it. Commands that are
+ * already waiting for an acknowledgement are not sent again, the tracker re-sends them
+ * automatically if needed.
+ *
+ * Returns @c false if the command was rejected, in which case the caller must not
+ * apply the change that the command requests. Commands that could not be written are
+ * accepted, since the tracker sends them again.
  */
-void Communicator::onErrorOccurred(const QAbstractSocket::SocketError socketError)
+bool Communicator::sendCommand(const QString &command)
 {
-    Q_UNUSED(socketError);
-    Misc::Utilities::showMessageBox(tr("TCP socket error"), m_socket.errorString());
+    if (!connectedToSerialStudio())
+        return false;
+
+    if (!CommandTracker::getInstance()->track(command))
+        return false;
+
+    if (!sendData(command))
+        LOG_WARNING() << "Command" << command
+                      << "could not be written, waiting for retry";
+
+    return true;
 }
 
 /**
- * Sends the given @a data string to Serial Studio, which in turn sends the data through
- * the serial port.
+ * Sends the given @a data string to all the connected Serial Studio instances, which in
+ * turn send the data through the serial port.
+ *
+ * The frame is encoded once for each kind of link, all the links of the same kind share
+ * the same buffer. Links in XBee API mode receive a transmit request addressed to the
+ * container, its frame ID is used to map the delivery report back to the command.
+ *
+ * The frameSent() signal carries the command bytes without the framing of each link
+ * (padding or API frame), together with the time at which they were sent.
+ *
+ * Returns @c false if no link wrote the frame completely.
  */
 bool Communicator::sendData(const QString &data)
 {
+    PROFILE_ZONE("Communicator::sendData");
+
     if (connectedToSerialStudio() && !data.isEmpty())
     {
-        // Add extra bytes to generate fixed-length string
-        QString copy = data;
-        while (copy.length() < 22)
-            copy.append("\n");
+        // Fan out frame to all links
+        bool sent = false;
+        const auto payload = data.toUtf8();
+        const auto timestamp = QDateTime::currentMSecsSinceEpoch();
+        QByteArray apiFrame;
+        QByteArray textFrame;
+        foreach (auto link, m_links)
+        {
+            // Build XBee transmit request, frame ID 0 is reserved (no delivery report)
+            if (link->apiMode())
+            {
+                if (apiFrame.isEmpty())
+                {
+                    m_frameId = m_frameId == 255 ? 1 : m_frameId + 1;
+                    m_frameCommands[m_frameId] = data;
+                    apiFrame = m_xbeeEncoder.transmitRequest(m_frameId, m_xbeeDestination,
+                                                             payload);
+                }
+
+                sent |= link->enqueue(apiFrame);
+            }
 
-        // Write data to TCP socket
-        auto bytes = copy.toUtf8();
-        auto wleng = m_socket.write(bytes);
+            // Add extra bytes to generate fixed-length string
+            else
+            {
+                if (textFrame.isEmpty())
+                {
+                    QString copy = data;
+                    while (copy.length() < 22)
+                        copy.append("\n");
 
-        // Calculate length of data sent
-        auto sentData = bytes;
-        sentData.chop(bytes.length() - wleng);
-        sentData.replace("\n", "");
+                    textFrame = copy.toUtf8();
+                }
+
+                sent |= link->enqueue(textFrame);
+            }
+        }
 
         // Update UI
-        emit rx("TX: " + QString::fromUtf8(sentData) + "\n");
-        return sentData.length() == bytes.length();
+        {
+            PROFILE_ZONE("QML onRx (TX)");
+            emit rx("TX: " + data + "\n");
+        }
+        emit frameSent(payload, timestamp);
+
+        // Report failure if no link accepted the frame
+        return sent;
     }
 
     return false;
@@ -23,9 +23,16 @@
 #ifndef SERIALSTUDIO_COMMUNICATOR_H
 #define SERIALSTUDIO_COMMUNICATOR_H
 
-#include <QFile>
+#include <QTimer>
 #include <QObject>
-#include <QTcpSocket>
+#include <QVariantList>
+#include <QElapsedTimer>
+
+#include <Mission/ProfileLibrary.h>
+#include <SerialStudio/Link.h>
+#include <SerialStudio/State.h>
+#include <Telemetry/Packet.h>
+#include <Telemetry/SequenceWindow.h>
 
 namespace SerialStudio
 {
@@ -33,55 +40,55 @@ class Communicator : public QObject
 {
     // clang-format off
     Q_OBJECT
-    Q_PROPERTY(bool connectedToSerialStudio
-               READ connectedToSerialStudio
-               NOTIFY connectedChanged)
-    Q_PROPERTY(bool simulationEnabled
-               READ simulationEnabled
-               WRITE setSimulationMode
-               NOTIFY simulationEnabledChanged)
-    Q_PROPERTY(bool simulationActivated
-               READ simulationActivated
-               WRITE setSimulationActivated
-               NOTIFY simulationActivatedChanged)
-    Q_PROPERTY(bool payload1TelemetryEnabled
-               READ payload1TelemetryEnabled
-               WRITE setPayload1TelemetryEnabled
-               NOTIFY payload1TelemetryEnabledChanged)
-    Q_PROPERTY(bool payload2TelemetryEnabled
-               READ payload2TelemetryEnabled
-               WRITE setPayload2TelemetryEnabled
-               NOTIFY payload2TelemetryEnabledChanged)
-    Q_PROPERTY(bool containerTelemetryEnabled
-               READ containerTelemetryEnabled
-               WRITE setContainerTelemetryEnabled
-               NOTIFY containerTelemetryEnabledChanged)
+    Q_PROPERTY(SerialStudio::State state
+               READ state
+               NOTIFY stateChanged)
     Q_PROPERTY(QString currentTime
                READ currentTime
                NOTIFY currentTimeChanged)
-    Q_PROPERTY(QString csvFileName
-               READ csvFileName
-               NOTIFY csvFileNameChanged)
-    Q_PROPERTY(QString currentSimulatedReading
-               READ currentSimulatedReading
-               NOTIFY currentSimulatedReadingChanged)
+    Q_PROPERTY(ClockPrecision clockPrecision
+               READ clockPrecision
+               WRITE setClockPrecision
+               NOTIFY clockPrecisionChanged)
+    Q_PROPERTY(bool clockPaused
+               READ clockPaused
+               WRITE setClockPaused
+               NOTIFY clockPausedChanged)
+    Q_PROPERTY(QVariantList links
+               READ links
+               NOTIFY linksChanged)
+    Q_PROPERTY(QStringList availableTransports
+               READ availableTransports
+               CONSTANT)
+    Q_PROPERTY(quint64 duplicatePackets
+               READ duplicatePackets
+               NOTIFY duplicatePacketsChanged)
     // clang-format on
 
 signals:
     void currentTimeChanged();
-    void csvFileNameChanged();
-    void simulationEnabledChanged();
-    void simulationActivatedChanged();
-    void connectedChanged();
-    void currentSimulatedReadingChanged();
-    void payload1TelemetryEnabledChanged();
-    void payload2TelemetryEnabledChanged();
-    void containerTelemetryEnabledChanged();
+    void clockPausedChanged();
+    void clockPrecisionChanged();
+    void stateChanged();
+    void linksChanged();
+    void duplicatePacketsChanged();
     void rx(const QString &data);
+    void frameSent(const QByteArray &frame, const qint64 timestamp);
+    void frameReceived(const QByteArray &frame, const qint64 timestamp);
+    void packetReceived(const Telemetry::Packet &packet);
 
 public:
+    enum ClockPrecision
+    {
+        Seconds,
+        Tenths,
+        Milliseconds,
+    };
+    Q_ENUM(ClockPrecision)
+
     static Communicator *getInstance();
 
+    State state() const;
     bool connectedToSerialStudio() const;
 
     bool simulationEnabled() const;
@@ -91,39 +98,84 @@ public:
     bool containerTelemetryEnabled() const;
 
     QString currentTime() const;
+    bool clockPaused() const;
+    ClockPrecision clockPrecision() const;
     QString csvFileName() const;
     QString currentSimulatedReading() const;
+    QString profileReport() const;
+
+    QVariantList links() const;
+    quint64 duplicatePackets() const;
+    QStringList availableTransports() const;
+
+    Q_INVOKABLE bool addLink(const QString &host, const int port,
+                             const QString &transport);
+    Q_INVOKABLE void removeLink(const int index);
+
+    bool sendStressFrame(const QString &frame);
+    void setProfileLoop(const bool loop);
+    void replaceLinks(const QString &host, const quint16 port,
+                      const Transport::Type transport);
 
 public slots:
     void openCsv();
+    void selectProfile(const int index);
     void tryConnection();
-    void releasePayload1();
-    void releasePayload2();
-    void updateContainerTime();
-    void setSimulationMode(const bool enabled);
-    void setSimulationActivated(const bool activated);
-    void setPayload1TelemetryEnabled(const bool enabled);
-    void setPayload2TelemetryEnabled(const bool enabled);
-    void setContainerTelemetryEnabled(const bool enabled);
+    bool releasePayload1();
+    bool releasePayload2();
+    bool updateContainerTime();
+    void setClockPaused(const bool paused);
+    void setClockPrecision(const ClockPrecision precision);
+    void sendSimulatedData();
+    bool setSimulationMode(const bool enabled);
+    bool setSimulationActivated(const bool activated);
+    bool setPayload1TelemetryEnabled(const bool enabled);
+    bool setPayload2TelemetryEnabled(const bool enabled);
+    bool setContainerTelemetryEnabled(const bool enabled);
 
 private slots:
+    void reconnectLinks();
     void updateCurrentTime();
-    void sendSimulatedData();
     void onConnectedChanged();
-    void onErrorOccurred(const QAbstractSocket::SocketError socketError);
+    void onPacketReceived(const QByteArray &line);
+    void onRetryRequested(const QString &command);
+    void onTransmitStatusReceived(const quint8 frameId, const quint8 status,
+                                  const quint8 retries);
+    void publishState();
 
 private:
     Communicator();
+    void markDirty(const int fields);
+    void saveLinks();
+    void registerLink(const QString &host, const quint16 port,
+                      const Transport::Type transport);
+    bool sendCommand(const QString &command);
     bool sendData(const QString &data);
 
 private:
-    QTcpSocket m_socket;
+    QList<Link *> m_links;
+    QElapsedTimer m_reconnectClock;
+
+    quint8 m_frameId;
+    XBeeEncoder m_xbeeEncoder;
+    quint64 m_xbeeDestination;
+    QString m_frameCommands[256];
+    quint64 m_duplicatePackets;
+
+    State m_state;
+    int m_dirtyFields;
+    Telemetry::SequenceWindow m_sequences[Telemetry::SourceCount];
 
     int m_row;
-    QFile m_file;
-    QFile m_tempFile;
+    QTimer m_clockTimer;
+    qint64 m_lastTick;
+    bool m_profileLoop;
+    bool m_stressMode;
+    bool m_clockPaused;
     QString m_currentTime;
-    QList<QStringList> m_csvData;
+    ClockPrecision m_clockPrecision;
+    Mission::SimulationProfilePointer m_profile;
+    Mission::SimulationProfilePointer m_pendingProfile;
     QString m_currentSimulationData;
 
     bool m_simulationEnabled;
@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Link.h"
+
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#include <Logger.h>
+#include <Misc/Metrics.h>
+#include <Misc/TimerEvents.h>
+
+using namespace SerialStudio;
+
+/*
+ * Maximum number of frames that can wait in the queue of a disconnected link
+ */
+#define MAX_QUEUE_DEPTH 32
+
+/*
+ * Frames that could not be written within this time (in ms) are discarded, so that a
+ * link that recovers does not forward stale commands to the CanSat. The age is measured
+ * with the clock of the timer module, which follows virtual time.
+ */
+#define MAX_QUEUE_AGE 2000
+
+/*
+ * Maximum number of bytes that we buffer while waiting for a line terminator
+ */
+#define MAX_RX_BUFFER_SIZE 1024 * 1024
+
+/**
+ * Constructor function
+ */
+Link::Link(const QString &host, const quint16 port, const Transport::Type transport,
+           QObject *parent)
+    : QObject(parent)
+    , m_host(host)
+    , m_port(port)
+    , m_transport(Transport::create(transport, this))
+    , m_apiMode(false)
+    , m_wasConnected(false)
+    , m_lastWriteComplete(true)
+    , m_everConnected(false)
+    , m_reconnects(0)
+    , m_framesSent(0)
+    , m_framesDropped(0)
+    , m_bytesSent(0)
+    , m_packetsReceived(0)
+{
+    // Talk with the radio in API mode if enabled
+    if (transport == Transport::Type::Serial)
+    {
+        auto xbee = XBeeSettings::load();
+        m_apiMode = xbee.apiMode;
+        m_decoder = XBeeDecoder(xbee.escaped);
+        m_knownAddresses = xbee.knownAddresses;
+    }
+
+    // Connect transport signals/slots
+    connect(m_transport, &Transport::dataReceived, this, &Link::onDataReceived);
+    connect(m_transport, &Transport::connectedChanged, this, &Link::onConnectedChanged);
+}
+
+/**
+ * Returns the host name or IP address of the Serial Studio instance
+ */
+QString Link::host() const
+{
+    return m_host;
+}
+
+/**
+ * Returns the port of the Serial Studio plugin server
+ */
+quint16 Link::port() const
+{
+    return m_port;
+}
+
+/**
+ * Returns the name of the transport used by the link
+ */
+QString Link::transport() const
+{
+    return Transport::typeName(transportType());
+}
+
+/**
+ * Returns the type of the transport used by the link
+ */
+Transport::Type Link::transportType() const
+{
+    return m_transport->type();
+}
+
+/**
+ * Returns @c true if the link sends & receives XBee API frames instead of text lines
+ */
+bool Link::apiMode() const
+{
+    return m_apiMode;
+}
+
+/**
+ * Returns @c true if the connection with Serial Studio is established
+ */
+bool Link::connected() const
+{
+    return m_transport->isConnected();
+}
+
+/**
+ * Returns a short, user-friendly description of the link state
+ */
+QString Link::status() const
+{
+    if (connected())
+        return tr("Online");
+
+    if (m_everConnected)
+        return tr("Reconnecting");
+
+    return tr("Offline");
+}
+
+/**
+ * Returns the number of frames waiting to be written to the socket
+ */
+int Link::queueDepth() const
+{
+    return m_queue.count();
+}
+
+/**
+ * Returns the number of times that the link was re-established after losing the
+ * connection with Serial Studio
+ */
+int Link::reconnects() const
+{
+    return m_reconnects;
+}
+
+/**
+ * Returns the number of frames written to the socket
+ */
+quint64 Link::framesSent() const
+{
+    return m_framesSent;
+}
+
+/**
+ * Returns the number of frames discarded because the link was down for too long
+ */
+quint64 Link::framesDropped() const
+{
+    return m_framesDropped;
+}
+
+/**
+ * Returns the number of bytes written to the socket
+ */
+quint64 Link::bytesSent() const
+{
+    return m_bytesSent;
+}
+
+/**
+ * Returns the number of telemetry lines received through this link
+ */
+quint64 Link::packetsReceived() const
+{
+    return m_packetsReceived;
+}
+
+/**
+ * Closes the connection & discards any pending frames
+ */
+void Link::close()
+{
+    Misc::Metrics::increment(Misc::Metrics::QueueDepth, -m_queue.count());
+    m_queue.clear();
+    m_transport->close();
+    emit healthChanged();
+}
+
+/**
+ * Tries to establish a connection with Serial Studio
+ */
+void Link::tryConnection()
+{
+    if (!connected())
+        m_transport->open(m_host, m_port);
+}
+
+/**
+ * Adds the given @a frame to the send queue & writes it immediately if the link is
+ * connected. The frame is shared (not copied) between all the links that receive it.
+ *
+ * Returns @c true if the frame was completely written to the transport, frames that
+ * remain queued (or that were only partially written) return @c false.
+ */
+bool Link::enqueue(const QByteArray &frame)
+{
+    // Drop oldest frame if queue is full
+    if (m_queue.count() >= MAX_QUEUE_DEPTH)
+    {
+        m_queue.dequeue();
+        ++m_framesDropped;
+        Misc::Metrics::increment(Misc::Metrics::FramesDropped);
+        Misc::Metrics::increment(Misc::Metrics::QueueDepth, -1);
+    }
+
+    // Register frame
+    QueuedFrame queuedFrame;
+    queuedFrame.data = frame;
+    queuedFrame.enqueuedAt = Misc::TimerEvents::getInstance()->elapsed();
+    m_queue.enqueue(queuedFrame);
+    Misc::Metrics::increment(Misc::Metrics::QueueDepth);
+
+    // Write frame, it is the last frame of the queue
+    flush();
+    return m_queue.isEmpty() && m_lastWriteComplete;
+}
+
+/**
+ * Writes all the queued frames to the socket, frames that waited too long for the link
+ * to come up are discarded.
+ */
+void Link::flush()
+{
+    const auto now = Misc::TimerEvents::getInstance()->elapsed();
+    while (!m_queue.isEmpty())
+    {
+        // Discard stale frames
+        if (now - m_queue.head().enqueuedAt > MAX_QUEUE_AGE)
+        {
+            m_queue.dequeue();
+            ++m_framesDropped;
+            Misc::Metrics::increment(Misc::Metrics::FramesDropped);
+            Misc::Metrics::increment(Misc::Metrics::QueueDepth, -1);
+            continue;
+        }
+
+        // Wait until the link is up
+        if (!connected())
+            break;
+
+        // Write frame to transport
+        const auto bytes = m_transport->write(m_queue.head().data);
+        if (bytes < 0)
+            break;
+
+        // Report partial writes
+        m_lastWriteComplete = bytes == m_queue.head().data.size();
+        if (!m_lastWriteComplete)
+            LOG_WARNING() << "Partial write to" << m_host << bytes << "of"
+                          << m_queue.head().data.size() << "bytes";
+
+        // Update counters
+        m_queue.dequeue();
+        ++m_framesSent;
+        m_bytesSent += static_cast<quint64>(bytes);
+        Misc::Metrics::increment(Misc::Metrics::FramesSent);
+        Misc::Metrics::increment(Misc::Metrics::BytesSent, bytes);
+        Misc::Metrics::increment(Misc::Metrics::QueueDepth, -1);
+    }
+
+    emit healthChanged();
+}
+
+/**
+ * Reads incoming data from Serial Studio. Serial Studio sends one JSON document per line,
+ * raw device data is encoded in Base64 inside the "data" field. Lines that are not JSON
+ * documents are treated as raw telemetry.
+ */
+void Link::onDataReceived(const QByteArray &data)
+{
+    // Decode XBee API frames
+    if (m_apiMode)
+    {
+        processApiFrames(data);
+        return;
+    }
+
+    // Read data & avoid growing forever if we never receive a line terminator
+    m_rxBuffer.append(data);
+    if (m_rxBuffer.size() > MAX_RX_BUFFER_SIZE)
+        m_rxBuffer.clear();
+
+    // Process each line
+    int index;
+    while ((index = m_rxBuffer.indexOf('\n')) >= 0)
+    {
+        auto line = m_rxBuffer.left(index).trimmed();
+        m_rxBuffer.remove(0, index + 1);
+
+        if (line.isEmpty())
+            continue;
+
+        if (line.startsWith('{'))
+        {
+            auto object = QJsonDocument::fromJson(line).object();
+            if (object.contains("data"))
+            {
+                auto data = object.value("data").toString().toUtf8();
+                processRawData(m_rawBuffer, QByteArray::fromBase64(data));
+            }
+        }
+
+        else
+        {
+            line.append('\n');
+            processRawData(m_rawBuffer, line);
+        }
+    }
+}
+
+/**
+ * Updates the reconnection counter & writes any frames that were queued while the link
+ * was down.
+ */
+void Link::onConnectedChanged()
+{
+    // Avoid notifying the UI if the connection state did not change
+    const bool isConnected = connected();
+    if (isConnected == m_wasConnected)
+        return;
+
+    // Link is now up
+    m_wasConnected = isConnected;
+    if (isConnected)
+    {
+        if (m_everConnected)
+        {
+            ++m_reconnects;
+            Misc::Metrics::increment(Misc::Metrics::Reconnects);
+        }
+
+        m_everConnected = true;
+        m_rxBuffer.clear();
+        m_rawBuffer.clear();
+        m_apiBuffers.clear();
+        m_decoder.reset();
+    }
+
+    // Update UI & send pending frames
+    emit connectedChanged();
+    flush();
+}
+
+/**
+ * Decodes the XBee API frames received from the radio. Telemetry is split into lines
+ * separately for each sender, so that packets from the container & the payloads are
+ * not mixed if they arrive interleaved. Frames from unknown radios are discarded when
+ * the addresses of the mission radios are configured.
+ */
+void Link::processApiFrames(const QByteArray &data)
+{
+    m_frames.resize(0);
+    m_decoder.decode(data, m_frames);
+    foreach (const auto &frame, m_frames)
+    {
+        if (frame.type == XBeeFrameType::TransmitStatus)
+            emit transmitStatusReceived(frame.frameId, frame.status, frame.retries);
+
+        else if (frame.type == XBeeFrameType::ReceivePacket)
+        {
+            if (m_knownAddresses.isEmpty() || m_knownAddresses.contains(frame.address))
+                processRawData(m_apiBuffers[frame.address], frame.data);
+        }
+    }
+}
+
+/**
+ * Appends the raw device @a data to the given @a buffer & splits it into telemetry lines
+ */
+void Link::processRawData(QByteArray &buffer, const QByteArray &data)
+{
+    buffer.append(data);
+    if (buffer.size() > MAX_RX_BUFFER_SIZE)
+        buffer.clear();
+
+    int index;
+    while ((index = buffer.indexOf('\n')) >= 0)
+    {
+        auto line = buffer.left(index).trimmed();
+        buffer.remove(0, index + 1);
+
+        if (!line.isEmpty())
+        {
+            ++m_packetsReceived;
+            emit packetReceived(line);
+        }
+    }
+}
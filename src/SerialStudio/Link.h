@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIALSTUDIO_LINK_H
+#define SERIALSTUDIO_LINK_H
+
+#include <QHash>
+#include <QQueue>
+#include <QObject>
+
+#include <SerialStudio/Transport.h>
+#include <SerialStudio/XBee.h>
+
+namespace SerialStudio
+{
+/**
+ * Connection with a single Serial Studio instance (e.g. the primary or the backup
+ * ground station). Each link has its own send queue, health counters & receive
+ * buffers, the @c Communicator class fans out commands to all the registered links.
+ *
+ * The bytes are carried by a @c Transport (TCP, UDP, local socket, loopback or serial
+ * port). Serial links may talk with the XBee radio in API mode, in which case frames
+ * are decoded by the link & delivery reports are forwarded to the @c Communicator.
+ */
+class Link : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(QString host
+               READ host
+               CONSTANT)
+    Q_PROPERTY(quint16 port
+               READ port
+               CONSTANT)
+    Q_PROPERTY(QString transport
+               READ transport
+               CONSTANT)
+    Q_PROPERTY(bool connected
+               READ connected
+               NOTIFY connectedChanged)
+    Q_PROPERTY(QString status
+               READ status
+               NOTIFY healthChanged)
+    Q_PROPERTY(int queueDepth
+               READ queueDepth
+               NOTIFY healthChanged)
+    Q_PROPERTY(int reconnects
+               READ reconnects
+               NOTIFY healthChanged)
+    Q_PROPERTY(quint64 framesSent
+               READ framesSent
+               NOTIFY healthChanged)
+    Q_PROPERTY(quint64 framesDropped
+               READ framesDropped
+               NOTIFY healthChanged)
+    Q_PROPERTY(quint64 bytesSent
+               READ bytesSent
+               NOTIFY healthChanged)
+    Q_PROPERTY(quint64 packetsReceived
+               READ packetsReceived
+               NOTIFY healthChanged)
+    // clang-format on
+
+signals:
+    void healthChanged();
+    void connectedChanged();
+    void packetReceived(const QByteArray &packet);
+    void transmitStatusReceived(const quint8 frameId, const quint8 status,
+                                const quint8 retries);
+
+public:
+    Link(const QString &host, const quint16 port, const Transport::Type transport,
+         QObject *parent = nullptr);
+
+    QString host() const;
+    quint16 port() const;
+    QString transport() const;
+    Transport::Type transportType() const;
+    bool apiMode() const;
+    bool connected() const;
+    QString status() const;
+
+    int queueDepth() const;
+    int reconnects() const;
+    quint64 framesSent() const;
+    quint64 framesDropped() const;
+    quint64 bytesSent() const;
+    quint64 packetsReceived() const;
+
+public slots:
+    void close();
+    void tryConnection();
+    bool enqueue(const QByteArray &frame);
+
+private slots:
+    void flush();
+    void onConnectedChanged();
+    void onDataReceived(const QByteArray &data);
+
+private:
+    void processApiFrames(const QByteArray &data);
+    void processRawData(QByteArray &buffer, const QByteArray &data);
+
+private:
+    struct QueuedFrame
+    {
+        QByteArray data;
+        qint64 enqueuedAt;
+    };
+
+    QString m_host;
+    quint16 m_port;
+    Transport *m_transport;
+
+    bool m_apiMode;
+    XBeeDecoder m_decoder;
+    QVector<XBeeFrame> m_frames;
+    QVector<quint64> m_knownAddresses;
+    QHash<quint64, QByteArray> m_apiBuffers;
+
+    bool m_wasConnected;
+    bool m_lastWriteComplete;
+    bool m_everConnected;
+    int m_reconnects;
+    quint64 m_framesSent;
+    quint64 m_framesDropped;
+    quint64 m_bytesSent;
+    quint64 m_packetsReceived;
+
+    QByteArray m_rxBuffer;
+    QByteArray m_rawBuffer;
+    QQueue<QueuedFrame> m_queue;
+};
+}
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "LocalTransport.h"
+
+using namespace SerialStudio;
+
+/**
+ * Constructor function
+ */
+LocalTransport::LocalTransport(QObject *parent)
+    : Transport(parent)
+{
+    connect(&m_socket, &QLocalSocket::readyRead, this, &LocalTransport::onReadyRead);
+    connect(&m_socket, &QLocalSocket::connected, this, &LocalTransport::onConnected);
+    connect(&m_socket, &QLocalSocket::disconnected, this,
+            &LocalTransport::onDisconnected);
+}
+
+/**
+ * Returns the transport type
+ */
+Transport::Type LocalTransport::type() const
+{
+    return Type::Local;
+}
+
+/**
+ * Returns @c true if the connection with the local server is established
+ */
+bool LocalTransport::isConnected() const
+{
+    return m_socket.state() == QLocalSocket::ConnectedState;
+}
+
+/**
+ * Writes the given @a data & flushes the socket immediately
+ */
+qint64 LocalTransport::write(const QByteArray &data)
+{
+    auto bytes = m_socket.write(data);
+    m_socket.flush();
+    return bytes;
+}
+
+/**
+ * Connects to the local server with the given @a host name
+ */
+void LocalTransport::open(const QString &host, const quint16 port)
+{
+    Q_UNUSED(port);
+    m_socket.abort();
+    m_socket.connectToServer(host);
+}
+
+/**
+ * Aborts the connection
+ */
+void LocalTransport::close()
+{
+    m_socket.abort();
+}
+
+/**
+ * Notifies the link
+ */
+void LocalTransport::onConnected()
+{
+    emit connectedChanged();
+}
+
+/**
+ * Closes the socket & notifies the link
+ */
+void LocalTransport::onDisconnected()
+{
+    m_socket.close();
+    emit connectedChanged();
+}
+
+/**
+ * Forwards received data to the link
+ */
+void LocalTransport::onReadyRead()
+{
+    emit dataReceived(m_socket.readAll());
+}
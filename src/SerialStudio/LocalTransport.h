@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIALSTUDIO_LOCAL_TRANSPORT_H
+#define SERIALSTUDIO_LOCAL_TRANSPORT_H
+
+#include <QLocalSocket>
+#include <SerialStudio/Transport.h>
+
+namespace SerialStudio
+{
+/**
+ * Connection with a Serial Studio instance running in the same computer through a
+ * Unix domain socket (or a named pipe on Windows). The host name is used as the server
+ * name & the port is ignored.
+ */
+class LocalTransport : public Transport
+{
+    Q_OBJECT
+
+public:
+    explicit LocalTransport(QObject *parent = nullptr);
+
+    Type type() const override;
+    bool isConnected() const override;
+    qint64 write(const QByteArray &data) override;
+    void open(const QString &host, const quint16 port) override;
+    void close() override;
+
+private slots:
+    void onConnected();
+    void onDisconnected();
+    void onReadyRead();
+
+private:
+    QLocalSocket m_socket;
+};
+}
+
+#endif
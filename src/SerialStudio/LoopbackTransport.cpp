@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "LoopbackTransport.h"
+
+#include <QMultiHash>
+
+using namespace SerialStudio;
+
+/*
+ * Open loopback transports, grouped by port number
+ */
+static QMultiHash<quint16, LoopbackTransport *> ENDPOINTS;
+
+/**
+ * Constructor function
+ */
+LoopbackTransport::LoopbackTransport(QObject *parent)
+    : Transport(parent)
+    , m_open(false)
+    , m_port(0)
+{
+}
+
+/**
+ * Destructor function, unregisters the transport
+ */
+LoopbackTransport::~LoopbackTransport()
+{
+    ENDPOINTS.remove(m_port, this);
+}
+
+/**
+ * Returns the transport type
+ */
+Transport::Type LoopbackTransport::type() const
+{
+    return Type::Loopback;
+}
+
+/**
+ * Returns @c true if the transport is open
+ */
+bool LoopbackTransport::isConnected() const
+{
+    return m_open;
+}
+
+/**
+ * Delivers the given @a data to all other loopback transports with the same port
+ */
+qint64 LoopbackTransport::write(const QByteArray &data)
+{
+    if (!m_open)
+        return -1;
+
+    auto peers = ENDPOINTS.values(m_port);
+    foreach (auto peer, peers)
+    {
+        if (peer != this)
+            emit peer->dataReceived(data);
+    }
+
+    return data.size();
+}
+
+/**
+ * Registers the transport with the given @a port, the @a host is ignored
+ */
+void LoopbackTransport::open(const QString &host, const quint16 port)
+{
+    Q_UNUSED(host);
+
+    close();
+    m_open = true;
+    m_port = port;
+    ENDPOINTS.insert(m_port, this);
+    emit connectedChanged();
+}
+
+/**
+ * Unregisters the transport
+ */
+void LoopbackTransport::close()
+{
+    if (m_open)
+    {
+        m_open = false;
+        ENDPOINTS.remove(m_port, this);
+        emit connectedChanged();
+    }
+}
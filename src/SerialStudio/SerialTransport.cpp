@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "SerialTransport.h"
+
+#include <QSettings>
+#include <Logger.h>
+
+using namespace SerialStudio;
+
+/*
+ * Baud rate used when the link host does not specify one, XBee radios ship at 9600 bps
+ */
+#define DEFAULT_BAUD_RATE 9600
+
+/**
+ * Constructor function, the serial port is created in the reader thread when the link
+ * is opened.
+ */
+SerialPortWorker::SerialPortWorker()
+    : m_port(nullptr)
+{
+}
+
+/**
+ * Closes the serial port
+ */
+void SerialPortWorker::close()
+{
+    if (m_port && m_port->isOpen())
+    {
+        m_port->close();
+        emit connectedChanged(false);
+    }
+}
+
+/**
+ * Writes the given @a data to the serial port without waiting for the next event loop
+ * iteration of the reader thread
+ */
+void SerialPortWorker::write(const QByteArray &data)
+{
+    if (m_port && m_port->isOpen())
+    {
+        m_port->write(data);
+        m_port->flush();
+    }
+}
+
+/**
+ * Opens the serial port with the given @a portName & @a baudRate, using the 8N1 format
+ * without flow control expected by the XBee radios
+ */
+void SerialPortWorker::open(const QString &portName, const int baudRate)
+{
+    // Create serial port in this thread
+    if (!m_port)
+    {
+        m_port = new QSerialPort(this);
+        connect(m_port, &QSerialPort::readyRead, this, &SerialPortWorker::onReadyRead);
+        connect(m_port, &QSerialPort::errorOccurred, this,
+                &SerialPortWorker::onErrorOccurred);
+    }
+
+    // Configure serial port
+    close();
+    m_port->setPortName(portName);
+    m_port->setBaudRate(baudRate);
+    m_port->setDataBits(QSerialPort::Data8);
+    m_port->setParity(QSerialPort::NoParity);
+    m_port->setStopBits(QSerialPort::OneStop);
+    m_port->setFlowControl(QSerialPort::NoFlowControl);
+
+    // Open serial port
+    if (m_port->open(QSerialPort::ReadWrite))
+    {
+        m_lastError.clear();
+        LOG_INFO() << "Opened serial port" << portName << "at" << baudRate << "bps";
+        emit connectedChanged(true);
+    }
+
+    // Log each failure once, the link retries several times per second
+    else
+    {
+        const auto error = m_port->errorString();
+        if (error != m_lastError)
+        {
+            m_lastError = error;
+            LOG_WARNING() << "Cannot open serial port" << portName << error;
+        }
+
+        emit connectedChanged(false);
+    }
+}
+
+/**
+ * Forwards received data to the transport
+ */
+void SerialPortWorker::onReadyRead()
+{
+    emit dataReceived(m_port->readAll());
+}
+
+/**
+ * Closes the serial port if the device was removed or stopped responding, errors that
+ * occur while opening the port are reported by open()
+ */
+void SerialPortWorker::onErrorOccurred(const QSerialPort::SerialPortError error)
+{
+    if (!m_port->isOpen())
+        return;
+
+    if (error == QSerialPort::ResourceError || error == QSerialPort::PermissionError)
+    {
+        LOG_WARNING() << "Serial port error" << m_port->portName()
+                      << m_port->errorString();
+        close();
+    }
+}
+
+/**
+ * Constructor function, starts the reader thread
+ */
+SerialTransport::SerialTransport(QObject *parent)
+    : Transport(parent)
+    , m_connected(false)
+    , m_opening(false)
+    , m_worker(new SerialPortWorker)
+{
+    // Move serial port worker to reader thread
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &SerialPortWorker::deleteLater);
+    connect(m_worker, &SerialPortWorker::dataReceived, this,
+            &SerialTransport::dataReceived);
+    connect(m_worker, &SerialPortWorker::connectedChanged, this,
+            &SerialTransport::onConnectedChanged);
+
+    // Start reader thread
+    m_thread.setObjectName("Serial port");
+    m_thread.start(QThread::TimeCriticalPriority);
+}
+
+/**
+ * Closes the serial port & stops the reader thread
+ */
+SerialTransport::~SerialTransport()
+{
+    QMetaObject::invokeMethod(m_worker, "close", Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+}
+
+/**
+ * Returns the transport type
+ */
+Transport::Type SerialTransport::type() const
+{
+    return Type::Serial;
+}
+
+/**
+ * Returns @c true if the serial port is open
+ */
+bool SerialTransport::isConnected() const
+{
+    return m_connected;
+}
+
+/**
+ * Hands the given @a data to the reader thread, which writes it to the serial port
+ */
+qint64 SerialTransport::write(const QByteArray &data)
+{
+    if (!m_connected)
+        return -1;
+
+    QMetaObject::invokeMethod(m_worker, "write", Qt::QueuedConnection,
+                              Q_ARG(QByteArray, data));
+    return data.size();
+}
+
+/**
+ * Opens the serial port given by the @a host, which may end with "@<baud rate>". The
+ * @a port number is not used by serial links.
+ */
+void SerialTransport::open(const QString &host, const quint16 port)
+{
+    Q_UNUSED(port);
+
+    // Wait for the previous attempt to finish
+    if (m_opening)
+        return;
+
+    // Get port name & baud rate
+    auto portName = host;
+    QSettings settings;
+    auto baudRate = settings.value("SerialTransport/baudRate", DEFAULT_BAUD_RATE).toInt();
+    const auto separator = host.lastIndexOf('@');
+    if (separator > 0)
+    {
+        bool ok = false;
+        const auto rate = host.mid(separator + 1).toInt(&ok);
+        if (ok && rate > 0)
+        {
+            baudRate = rate;
+            portName = host.left(separator);
+        }
+    }
+
+    // Open serial port in reader thread
+    m_opening = true;
+    QMetaObject::invokeMethod(m_worker, "open", Qt::QueuedConnection,
+                              Q_ARG(QString, portName), Q_ARG(int, baudRate));
+}
+
+/**
+ * Closes the serial port
+ */
+void SerialTransport::close()
+{
+    QMetaObject::invokeMethod(m_worker, "close", Qt::QueuedConnection);
+    if (m_connected)
+    {
+        m_connected = false;
+        emit connectedChanged();
+    }
+}
+
+/**
+ * Updates the connection state reported by the reader thread & notifies the link
+ */
+void SerialTransport::onConnectedChanged(const bool connected)
+{
+    m_opening = false;
+    if (m_connected != connected)
+    {
+        m_connected = connected;
+        emit connectedChanged();
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIALSTUDIO_SERIAL_TRANSPORT_H
+#define SERIALSTUDIO_SERIAL_TRANSPORT_H
+
+#include <QThread>
+#include <QSerialPort>
+
+#include <SerialStudio/Transport.h>
+
+namespace SerialStudio
+{
+/**
+ * Owns the serial port in the reader thread of a @c SerialTransport, @c QSerialPort is
+ * not thread-safe, so all the port operations are invoked through queued calls.
+ */
+class SerialPortWorker : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void connectedChanged(const bool connected);
+    void dataReceived(const QByteArray &data);
+
+public:
+    SerialPortWorker();
+
+public slots:
+    void close();
+    void write(const QByteArray &data);
+    void open(const QString &portName, const int baudRate);
+
+private slots:
+    void onReadyRead();
+    void onErrorOccurred(const QSerialPort::SerialPortError error);
+
+private:
+    QSerialPort *m_port;
+    QString m_lastError;
+};
+
+/**
+ * Drives the ground station radio directly through a serial port, without going through
+ * Serial Studio. The host of the link is the port name (e.g. "/dev/ttyUSB0" or "COM3"),
+ * optionally followed by the baud rate (e.g. "/dev/ttyUSB0@115200").
+ *
+ * The port is read & written by a dedicated thread, so that telemetry bursts & the UI
+ * do not delay each other.
+ */
+class SerialTransport : public Transport
+{
+    Q_OBJECT
+
+public:
+    explicit SerialTransport(QObject *parent = nullptr);
+    ~SerialTransport() override;
+
+    Type type() const override;
+    bool isConnected() const override;
+    qint64 write(const QByteArray &data) override;
+    void open(const QString &host, const quint16 port) override;
+    void close() override;
+
+private slots:
+    void onConnectedChanged(const bool connected);
+
+private:
+    bool m_connected;
+    bool m_opening;
+    QThread m_thread;
+    SerialPortWorker *m_worker;
+};
+}
+
+#endif
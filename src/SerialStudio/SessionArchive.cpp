@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "SessionArchive.h"
+
+#include <QTimer>
+#include <QDataStream>
+#include <Logger.h>
+
+using namespace SerialStudio;
+
+/*
+ * Magic numbers of the archive sections
+ */
+#define FILE_MAGIC 0x43433231  // "CC21"
+#define CHUNK_MAGIC 0x43484E4B // "CHNK"
+#define INDEX_MAGIC 0x494E4458 // "INDX"
+#define END_MAGIC 0x454E4421   // "END!"
+#define FILE_VERSION 1
+
+/*
+ * Size of the file header (magic + version) & of the trailer (index offset + magic)
+ */
+#define HEADER_SIZE 8
+#define TRAILER_SIZE 12
+
+/*
+ * Maximum amount of raw data in a chunk
+ */
+#define CHUNK_SIZE (256 * 1024)
+
+/*
+ * Maximum time (in ms) that records are kept in memory before their chunk is written
+ */
+#define CHUNK_INTERVAL 30000
+
+/**
+ * Constructor function
+ */
+SessionArchiveWriter::SessionArchiveWriter()
+    : m_timer(new QTimer(this))
+    , m_records(0)
+    , m_first(0)
+    , m_last(0)
+    , m_rawBytes(0)
+{
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(CHUNK_INTERVAL);
+    connect(m_timer, &QTimer::timeout, this, &SessionArchiveWriter::writeChunk);
+}
+
+/**
+ * Writes the pending records, the chunk index & the trailer, then closes the archive
+ */
+void SessionArchiveWriter::close()
+{
+    if (!m_file.isOpen())
+        return;
+
+    // Write last chunk
+    writeChunk();
+
+    // Write chunk index
+    QDataStream out(&m_file);
+    const qint64 indexOffset = m_file.pos();
+    out << quint32(INDEX_MAGIC) << quint32(m_chunks.count());
+    foreach (const auto &chunk, m_chunks)
+        out << chunk.offset << chunk.first << chunk.last << chunk.records;
+
+    // Write trailer
+    out << indexOffset << quint32(END_MAGIC);
+
+    // Close file
+    LOG_INFO() << "Closed session archive" << m_file.fileName() << "with"
+               << m_chunks.count() << "chunks";
+    m_file.close();
+    m_chunks.clear();
+}
+
+/**
+ * Creates a new archive at the given @a path, closing the current archive
+ */
+void SessionArchiveWriter::open(const QString &path)
+{
+    close();
+
+    m_rawBytes = 0;
+    m_file.setFileName(path);
+    if (!m_file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        LOG_WARNING() << "Cannot create session archive" << path << m_file.errorString();
+        return;
+    }
+
+    QDataStream out(&m_file);
+    out << quint32(FILE_MAGIC) << quint32(FILE_VERSION);
+    LOG_INFO() << "Recording session archive" << path;
+}
+
+/**
+ * Adds a record to the current chunk, the chunk is compressed & written when it reaches
+ * its maximum size
+ */
+void SessionArchiveWriter::append(const qint64 timestamp, const int direction,
+                                  const QByteArray &data)
+{
+    if (!m_file.isOpen())
+        return;
+
+    // Start new chunk
+    if (m_records == 0)
+    {
+        m_first = timestamp;
+        m_timer->start();
+    }
+
+    // Serialize record
+    QDataStream out(&m_buffer, QIODevice::WriteOnly | QIODevice::Append);
+    out << timestamp << quint8(direction) << data;
+    m_last = timestamp;
+    ++m_records;
+
+    // Write full chunk
+    if (m_buffer.size() >= CHUNK_SIZE)
+        writeChunk();
+}
+
+/**
+ * Compresses the buffered records & appends them to the archive as a new chunk
+ */
+void SessionArchiveWriter::writeChunk()
+{
+    m_timer->stop();
+    if (m_records == 0 || !m_file.isOpen())
+        return;
+
+    // Register chunk
+    SessionChunk chunk;
+    chunk.offset = m_file.pos();
+    chunk.first = m_first;
+    chunk.last = m_last;
+    chunk.records = m_records;
+    m_chunks.append(chunk);
+
+    // Write chunk header & compressed data
+    QDataStream out(&m_file);
+    out << quint32(CHUNK_MAGIC) << chunk.first << chunk.last << chunk.records
+        << qCompress(m_buffer);
+    m_file.flush();
+
+    // Update statistics
+    m_rawBytes += m_buffer.size();
+    emit statisticsChanged(m_rawBytes, m_file.pos());
+
+    // Reset buffer
+    m_records = 0;
+    m_buffer.resize(0);
+}
+
+/**
+ * Opens the archive at the given @a path & loads its chunk index
+ */
+bool SessionArchiveReader::open(const QString &path)
+{
+    // Open file
+    m_chunks.clear();
+    m_file.close();
+    m_file.setFileName(path);
+    if (!m_file.open(QFile::ReadOnly))
+    {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    // Validate header
+    quint32 magic, version;
+    QDataStream in(&m_file);
+    in >> magic >> version;
+    if (magic != FILE_MAGIC || version != FILE_VERSION)
+    {
+        m_error = tr("Not a session archive");
+        m_file.close();
+        return false;
+    }
+
+    // Load index, or rebuild it if the archive was not closed
+    if (!readIndex())
+        return scanChunks();
+
+    return true;
+}
+
+/**
+ * Returns the description of the last error
+ */
+QString SessionArchiveReader::errorString() const
+{
+    return m_error;
+}
+
+/**
+ * Returns the index of the archive chunks
+ */
+const QVector<SessionChunk> &SessionArchiveReader::chunks() const
+{
+    return m_chunks;
+}
+
+/**
+ * Returns the records with a timestamp in the [@a from, @a to] range, only the chunks
+ * that overlap the range are read & decompressed
+ */
+QVector<SessionRecord> SessionArchiveReader::read(const qint64 from, const qint64 to)
+{
+    QVector<SessionRecord> records;
+    if (!m_file.isOpen())
+        return records;
+
+    QDataStream in(&m_file);
+    foreach (const auto &chunk, m_chunks)
+    {
+        // Skip chunks outside of the range
+        if (chunk.last < from || chunk.first > to)
+            continue;
+
+        // Read chunk
+        quint32 magic, count;
+        qint64 first, last;
+        QByteArray compressed;
+        m_file.seek(chunk.offset);
+        in >> magic >> first >> last >> count >> compressed;
+        if (magic != CHUNK_MAGIC || in.status() != QDataStream::Ok)
+        {
+            m_error = tr("Corrupted chunk at offset %1").arg(chunk.offset);
+            in.resetStatus();
+            continue;
+        }
+
+        // Decode records
+        const auto data = qUncompress(compressed);
+        QDataStream stream(data);
+        for (quint32 i = 0; i < count && !stream.atEnd(); ++i)
+        {
+            SessionRecord record;
+            stream >> record.timestamp >> record.direction >> record.data;
+            if (record.timestamp >= from && record.timestamp <= to)
+                records.append(record);
+        }
+    }
+
+    return records;
+}
+
+/**
+ * Reads the chunk index from the end of the archive
+ */
+bool SessionArchiveReader::readIndex()
+{
+    // Read trailer
+    if (m_file.size() < HEADER_SIZE + TRAILER_SIZE)
+        return false;
+
+    quint32 magic;
+    qint64 indexOffset;
+    QDataStream in(&m_file);
+    m_file.seek(m_file.size() - TRAILER_SIZE);
+    in >> indexOffset >> magic;
+    if (magic != END_MAGIC || indexOffset < HEADER_SIZE || indexOffset >= m_file.size())
+        return false;
+
+    // Read index
+    quint32 count;
+    m_file.seek(indexOffset);
+    in >> magic >> count;
+    if (magic != INDEX_MAGIC)
+        return false;
+
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        SessionChunk chunk;
+        in >> chunk.offset >> chunk.first >> chunk.last >> chunk.records;
+        m_chunks.append(chunk);
+    }
+
+    if (in.status() != QDataStream::Ok)
+    {
+        m_chunks.clear();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Rebuilds the chunk index by reading the chunk headers, stops at the first incomplete
+ * chunk
+ */
+bool SessionArchiveReader::scanChunks()
+{
+    m_chunks.clear();
+    m_file.seek(HEADER_SIZE);
+
+    QDataStream in(&m_file);
+    while (!in.atEnd())
+    {
+        // Read chunk header
+        SessionChunk chunk;
+        quint32 magic, length;
+        chunk.offset = m_file.pos();
+        in >> magic >> chunk.first >> chunk.last >> chunk.records >> length;
+        if (magic != CHUNK_MAGIC || in.status() != QDataStream::Ok)
+            break;
+
+        // Skip compressed data
+        if (length == 0xFFFFFFFF || !m_file.seek(m_file.pos() + length)
+            || m_file.pos() > m_file.size())
+            break;
+
+        m_chunks.append(chunk);
+    }
+
+    LOG_INFO() << "Rebuilt index of" << m_file.fileName() << "with" << m_chunks.count()
+               << "chunks";
+    return true;
+}
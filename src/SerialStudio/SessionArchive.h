@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIALSTUDIO_SESSION_ARCHIVE_H
+#define SERIALSTUDIO_SESSION_ARCHIVE_H
+
+#include <QFile>
+#include <QObject>
+#include <QVector>
+#include <QByteArray>
+#include <QCoreApplication>
+
+class QTimer;
+
+namespace SerialStudio
+{
+/**
+ * Frame transmitted to or received from Serial Studio during a session
+ */
+struct SessionRecord
+{
+    enum Direction
+    {
+        Transmitted = 0,
+        Received = 1,
+    };
+
+    qint64 timestamp;
+    quint8 direction;
+    QByteArray data;
+};
+
+/**
+ * Location & time range of a compressed chunk inside a session archive
+ */
+struct SessionChunk
+{
+    qint64 offset;
+    qint64 first;
+    qint64 last;
+    quint32 records;
+};
+
+/**
+ * Writes session archives. Records are buffered & compressed (with qCompress) in
+ * independently decodable chunks of up to 256 KiB of raw data, each chunk header
+ * contains the time range of its records. When the archive is closed, an index of all
+ * chunks is appended to the file, followed by a trailer with the index offset.
+ *
+ * The writer is designed to live in its own thread, so that compression & disk I/O do
+ * not block the recording of new frames.
+ */
+class SessionArchiveWriter : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void statisticsChanged(const qint64 rawBytes, const qint64 compressedBytes);
+
+public:
+    SessionArchiveWriter();
+
+public slots:
+    void close();
+    void open(const QString &path);
+    void append(const qint64 timestamp, const int direction, const QByteArray &data);
+
+private slots:
+    void writeChunk();
+
+private:
+    QFile m_file;
+    QTimer *m_timer;
+    QByteArray m_buffer;
+    quint32 m_records;
+    qint64 m_first;
+    qint64 m_last;
+    qint64 m_rawBytes;
+    QVector<SessionChunk> m_chunks;
+};
+
+/**
+ * Reads session archives. The chunk index is loaded from the end of the file, or
+ * rebuilt by scanning the chunk headers if the archive was not closed properly (e.g.
+ * after a crash). Only the chunks that overlap the requested time range are
+ * decompressed.
+ */
+class SessionArchiveReader
+{
+    Q_DECLARE_TR_FUNCTIONS(SessionArchiveReader)
+
+public:
+    bool open(const QString &path);
+    QString errorString() const;
+    const QVector<SessionChunk> &chunks() const;
+    QVector<SessionRecord> read(const qint64 from, const qint64 to);
+
+private:
+    bool readIndex();
+    bool scanChunks();
+
+private:
+    QFile m_file;
+    QString m_error;
+    QVector<SessionChunk> m_chunks;
+};
+}
+
+#endif
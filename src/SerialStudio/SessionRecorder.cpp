@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "SessionRecorder.h"
+#include "SessionArchive.h"
+#include "Communicator.h"
+
+#include <QDir>
+#include <QSettings>
+#include <QDateTime>
+#include <QApplication>
+
+#include <AppInfo.h>
+
+using namespace SerialStudio;
+
+/*
+ * Pointer to singleton instance of class
+ */
+static SessionRecorder *INSTANCE = nullptr;
+
+/**
+ * Constructor function
+ */
+SessionRecorder::SessionRecorder()
+    : m_enabled(false)
+    , m_rawBytes(0)
+    , m_compressedBytes(0)
+    , m_writer(new SessionArchiveWriter)
+{
+    // Run the archive writer in its own thread
+    m_writer->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_writer, &SessionArchiveWriter::deleteLater);
+    connect(this, &SessionRecorder::recordAppended, m_writer,
+            &SessionArchiveWriter::append);
+    connect(m_writer, &SessionArchiveWriter::statisticsChanged, this,
+            &SessionRecorder::onStatisticsChanged);
+    m_thread.setObjectName("Session archive");
+    m_thread.start(QThread::LowPriority);
+
+    // Record TX/RX frames & close the archive before exiting
+    auto communicator = Communicator::getInstance();
+    connect(communicator, &Communicator::frameSent, this, &SessionRecorder::onFrameSent);
+    connect(communicator, &Communicator::frameReceived, this,
+            &SessionRecorder::onFrameReceived);
+    connect(qApp, &QApplication::aboutToQuit, this, &SessionRecorder::stop);
+
+    // Restore recording state
+    setEnabled(QSettings().value("SessionRecorder/enabled", false).toBool());
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+SessionRecorder *SessionRecorder::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new SessionRecorder;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if the session is being recorded
+ */
+bool SessionRecorder::enabled() const
+{
+    return m_enabled;
+}
+
+/**
+ * Returns the path of the current session archive
+ */
+QString SessionRecorder::fileName() const
+{
+    return m_fileName;
+}
+
+/**
+ * Returns the raw & compressed size of the current session archive
+ */
+QString SessionRecorder::statistics() const
+{
+    if (m_compressedBytes <= 0)
+        return tr("Nothing recorded yet");
+
+    return tr("%1 KB recorded, %2 KB on disk (%3:1)")
+        .arg(m_rawBytes / 1024)
+        .arg(m_compressedBytes / 1024)
+        .arg(static_cast<double>(m_rawBytes) / m_compressedBytes, 0, 'f', 1);
+}
+
+/**
+ * Closes the session archive & stops the writer thread
+ */
+void SessionRecorder::stop()
+{
+    if (m_thread.isRunning())
+    {
+        QMetaObject::invokeMethod(m_writer, "close", Qt::BlockingQueuedConnection);
+        m_thread.quit();
+        m_thread.wait();
+    }
+}
+
+/**
+ * Starts or stops recording the session
+ */
+void SessionRecorder::setEnabled(const bool enabled)
+{
+    if (m_enabled == enabled || !m_thread.isRunning())
+        return;
+
+    m_enabled = enabled;
+    if (enabled)
+        openArchive();
+    else
+        QMetaObject::invokeMethod(m_writer, "close", Qt::QueuedConnection);
+
+    QSettings().setValue("SessionRecorder/enabled", enabled);
+    emit enabledChanged();
+}
+
+/**
+ * Registers a @a frame sent to the CanSat at the given @a timestamp
+ */
+void SessionRecorder::onFrameSent(const QByteArray &frame, const qint64 timestamp)
+{
+    if (m_enabled)
+        emit recordAppended(timestamp, SessionRecord::Transmitted, frame);
+}
+
+/**
+ * Registers a telemetry @a frame received at the given @a timestamp
+ */
+void SessionRecorder::onFrameReceived(const QByteArray &frame, const qint64 timestamp)
+{
+    if (m_enabled)
+        emit recordAppended(timestamp, SessionRecord::Received, frame);
+}
+
+/**
+ * Updates the archive size displayed by the user interface
+ */
+void SessionRecorder::onStatisticsChanged(const qint64 rawBytes,
+                                          const qint64 compressedBytes)
+{
+    m_rawBytes = rawBytes;
+    m_compressedBytes = compressedBytes;
+    emit statisticsChanged();
+}
+
+/**
+ * Creates a new session archive in the sessions directory
+ */
+void SessionRecorder::openArchive()
+{
+    QDir().mkpath(SESSION_ARCHIVE_DIR);
+    auto date = QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss");
+    m_fileName = QString("%1/Session_%2.cc2021session").arg(SESSION_ARCHIVE_DIR, date);
+
+    m_rawBytes = 0;
+    m_compressedBytes = 0;
+    emit statisticsChanged();
+
+    QMetaObject::invokeMethod(m_writer, "open", Qt::QueuedConnection,
+                              Q_ARG(QString, m_fileName));
+}
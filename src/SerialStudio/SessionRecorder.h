@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIALSTUDIO_SESSION_RECORDER_H
+#define SERIALSTUDIO_SESSION_RECORDER_H
+
+#include <QThread>
+#include <QObject>
+
+namespace SerialStudio
+{
+class SessionArchiveWriter;
+
+/**
+ * Records all the frames transmitted to & received from Serial Studio in a compressed
+ * session archive. Frames are handed over to a writer that runs in its own thread,
+ * which compresses & stores them while the recording continues.
+ */
+class SessionRecorder : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(QString fileName
+               READ fileName
+               NOTIFY enabledChanged)
+    Q_PROPERTY(QString statistics
+               READ statistics
+               NOTIFY statisticsChanged)
+    // clang-format on
+
+signals:
+    void enabledChanged();
+    void statisticsChanged();
+    void recordAppended(const qint64 timestamp, const int direction,
+                        const QByteArray &data);
+
+public:
+    static SessionRecorder *getInstance();
+
+    bool enabled() const;
+    QString fileName() const;
+    QString statistics() const;
+
+public slots:
+    void stop();
+    void setEnabled(const bool enabled);
+
+private slots:
+    void onFrameSent(const QByteArray &frame, const qint64 timestamp);
+    void onFrameReceived(const QByteArray &frame, const qint64 timestamp);
+    void onStatisticsChanged(const qint64 rawBytes, const qint64 compressedBytes);
+
+private:
+    SessionRecorder();
+    void openArchive();
+
+private:
+    bool m_enabled;
+    qint64 m_rawBytes;
+    qint64 m_compressedBytes;
+    QString m_fileName;
+    QThread m_thread;
+    SessionArchiveWriter *m_writer;
+};
+}
+
+#endif
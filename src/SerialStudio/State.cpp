@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "State.h"
+
+using namespace SerialStudio;
+
+/**
+ * Constructor function, creates a snapshot with the default (disconnected) state
+ */
+State::State()
+    : m_connected(false)
+    , m_simulationEnabled(false)
+    , m_simulationActivated(false)
+    , m_payload1TelemetryEnabled(true)
+    , m_payload2TelemetryEnabled(true)
+    , m_containerTelemetryEnabled(false)
+    , m_changedFields(0)
+{
+}
+
+/**
+ * Returns @c true if at least one link with Serial Studio is connected
+ */
+bool State::connected() const
+{
+    return m_connected;
+}
+
+/**
+ * Returns @c true if the simulation mode is enabled
+ */
+bool State::simulationEnabled() const
+{
+    return m_simulationEnabled;
+}
+
+/**
+ * Returns @c true if simulation mode is enabled & active
+ */
+bool State::simulationActivated() const
+{
+    return m_simulationActivated;
+}
+
+/**
+ * Returns @c true if SP1 telemetry is enabled
+ */
+bool State::payload1TelemetryEnabled() const
+{
+    return m_payload1TelemetryEnabled;
+}
+
+/**
+ * Returns @c true if SP2 telemetry is enabled
+ */
+bool State::payload2TelemetryEnabled() const
+{
+    return m_payload2TelemetryEnabled;
+}
+
+/**
+ * Returns @c true if container telemetry is enabled
+ */
+bool State::containerTelemetryEnabled() const
+{
+    return m_containerTelemetryEnabled;
+}
+
+/**
+ * Returns the name of the loaded simulation CSV file
+ */
+QString State::csvFileName() const
+{
+    return m_csvFileName;
+}
+
+/**
+ * Returns the last simulated pressure reading sent to the CanSat
+ */
+QString State::currentSimulatedReading() const
+{
+    return m_currentSimulatedReading;
+}
+
+/**
+ * Returns the validation report of the loaded pressure profile
+ */
+QString State::profileReport() const
+{
+    return m_profileReport;
+}
+
+/**
+ * Returns a mask with the fields that changed since the previous snapshot
+ */
+int State::changedFields() const
+{
+    return m_changedFields;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIALSTUDIO_STATE_H
+#define SERIALSTUDIO_STATE_H
+
+#include <QString>
+#include <QMetaType>
+
+namespace SerialStudio
+{
+class Communicator;
+
+/**
+ * Immutable snapshot of the state of the communicator that is displayed by the user
+ * interface. The communicator publishes a new snapshot at most once per event loop
+ * iteration, so a burst of state changes only re-evaluates the QML bindings once.
+ *
+ * The @c changedFields mask indicates which fields differ from the previous snapshot.
+ */
+class State
+{
+    // clang-format off
+    Q_GADGET
+    Q_PROPERTY(bool connected
+               READ connected)
+    Q_PROPERTY(bool simulationEnabled
+               READ simulationEnabled)
+    Q_PROPERTY(bool simulationActivated
+               READ simulationActivated)
+    Q_PROPERTY(bool payload1TelemetryEnabled
+               READ payload1TelemetryEnabled)
+    Q_PROPERTY(bool payload2TelemetryEnabled
+               READ payload2TelemetryEnabled)
+    Q_PROPERTY(bool containerTelemetryEnabled
+               READ containerTelemetryEnabled)
+    Q_PROPERTY(QString csvFileName
+               READ csvFileName)
+    Q_PROPERTY(QString currentSimulatedReading
+               READ currentSimulatedReading)
+    Q_PROPERTY(QString profileReport
+               READ profileReport)
+    Q_PROPERTY(int changedFields
+               READ changedFields)
+    // clang-format on
+
+public:
+    enum Field
+    {
+        Connected = 0x001,
+        SimulationEnabled = 0x002,
+        SimulationActivated = 0x004,
+        Payload1Telemetry = 0x008,
+        Payload2Telemetry = 0x010,
+        ContainerTelemetry = 0x020,
+        CsvFileName = 0x040,
+        SimulatedReading = 0x080,
+        ProfileReport = 0x100,
+        AllFields = 0x1FF,
+    };
+    Q_ENUM(Field)
+
+    State();
+
+    bool connected() const;
+    bool simulationEnabled() const;
+    bool simulationActivated() const;
+    bool payload1TelemetryEnabled() const;
+    bool payload2TelemetryEnabled() const;
+    bool containerTelemetryEnabled() const;
+    QString csvFileName() const;
+    QString currentSimulatedReading() const;
+    QString profileReport() const;
+    int changedFields() const;
+
+private:
+    friend class Communicator;
+
+    bool m_connected;
+    bool m_simulationEnabled;
+    bool m_simulationActivated;
+    bool m_payload1TelemetryEnabled;
+    bool m_payload2TelemetryEnabled;
+    bool m_containerTelemetryEnabled;
+    QString m_csvFileName;
+    QString m_currentSimulatedReading;
+    QString m_profileReport;
+    int m_changedFields;
+};
+}
+
+Q_DECLARE_METATYPE(SerialStudio::State)
+
+#endif
@@ -0,0 +1,625 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "StressTest.h"
+#include "Communicator.h"
+
+#include <limits>
+
+#include <QDir>
+#include <QFile>
+#include <QSettings>
+#include <QTcpSocket>
+#include <QtAlgorithms>
+#include <QApplication>
+#include <QElapsedTimer>
+
+#include <Logger.h>
+#include <Misc/RenderStats.h>
+#include <Misc/TimerEvents.h>
+#include <Mission/ProfileLibrary.h>
+
+#if defined(Q_OS_WIN)
+#    include <windows.h>
+#    include <psapi.h>
+#elif defined(Q_OS_MACOS)
+#    include <mach/mach.h>
+#else
+#    include <unistd.h>
+#endif
+
+using namespace SerialStudio;
+
+/*
+ * Default test duration (in seconds) & time (in ms) that the pipeline runs before the
+ * measurement starts
+ */
+#define DEFAULT_DURATION 30
+#define WARMUP_DURATION  3000
+
+/*
+ * Maximum number of frames written but not yet received by the sink, this makes the
+ * test run as fast as the link accepts frames instead of filling the socket buffers
+ */
+#define MAX_IN_FLIGHT 64
+
+/*
+ * Maximum number of frames generated before returning to the event loop
+ */
+#define MAX_BATCH 256
+
+/*
+ * Every BURST_PERIOD frames, BURST_SIZE commands are sent back to back
+ */
+#define BURST_PERIOD 100
+#define BURST_SIZE   8
+
+/*
+ * Time (in ms) that we wait for the sink to receive the last frames & for the link
+ * to connect to the sink
+ */
+#define DRAIN_TIMEOUT   1000
+#define LINK_TIMEOUT    5000
+#define LINK_POLL_DELAY 100
+
+/*
+ * Default tolerance for regressions with respect to the baseline & minimum memory
+ * growth (in KB) that is considered a regression
+ */
+#define DEFAULT_TOLERANCE  0.1
+#define MIN_MEMORY_GROWTH  1024
+
+/*
+ * Number of rows of the synthetic simulation profile
+ */
+#define PROFILE_ROWS 3600
+
+/*
+ * Frame counters & send times shared by the GUI & sink threads. Only MAX_IN_FLIGHT
+ * send times are needed at any time, so they are stored in a small ring buffer.
+ */
+static const int SEND_TIMES_SIZE = 1024;
+static QElapsedTimer CLOCK;
+static std::atomic<qint64> SENT(0);
+static std::atomic<qint64> RECEIVED(0);
+static std::atomic<qint64> MEASURE_FROM(std::numeric_limits<qint64>::max());
+static std::atomic<qint64> SEND_TIMES[SEND_TIMES_SIZE];
+
+/*
+ * Commands sent during the command bursts
+ */
+static const char *COMMANDS[] = {"CMD,1714,CX,ON;", "CMD,1714,SP1X,ON;",
+                                 "CMD,1714,SP2X,ON;", "CMD,1714,ST,00:00:00;"};
+static const int COMMAND_COUNT = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+
+/*
+ * Prefix of the SIM commands (and their retries) that enable the simulation, the sink
+ * does not count them as test frames
+ */
+static const char SIM_PREFIX[] = "CMD,1714,SIM,";
+static const int SIM_PREFIX_LENGTH = sizeof(SIM_PREFIX) - 1;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static StressTest *INSTANCE = nullptr;
+
+/**
+ * Constructor function
+ */
+StressSink::StressSink()
+    : m_server(nullptr)
+    , m_samples(0)
+{
+    for (int i = 0; i < BucketCount; ++i)
+        m_histogram[i] = 0;
+}
+
+/**
+ * Returns the histogram bucket of the given latency, buckets are log-linear (16
+ * buckets per power of two), so the relative error is always below 6.25%
+ */
+int StressSink::bucket(const qint64 nsecs)
+{
+    if (nsecs < 16)
+        return static_cast<int>(qMax<qint64>(0, nsecs));
+
+    const int msb = 63 - qCountLeadingZeroBits(static_cast<quint64>(nsecs));
+    const int sub = static_cast<int>((nsecs >> (msb - 4)) & 0xF);
+    return qMin(BucketCount - 1, (msb - 3) * 16 + sub);
+}
+
+/**
+ * Returns the latency (in ns) represented by the given @a bucket
+ */
+qint64 StressSink::bucketValue(const int bucket)
+{
+    if (bucket < 16)
+        return bucket;
+
+    const int msb = bucket / 16 + 3;
+    const int sub = bucket % 16;
+    return static_cast<qint64>(16 + sub) << (msb - 4);
+}
+
+/**
+ * Returns the latency (in ns) below which the given @a fraction of the measured frames
+ * were received
+ */
+qint64 StressSink::percentile(const double fraction) const
+{
+    if (m_samples == 0)
+        return 0;
+
+    quint64 count = 0;
+    const auto target = qMax<quint64>(1, static_cast<quint64>(fraction * m_samples));
+    for (int i = 0; i < BucketCount; ++i)
+    {
+        count += m_histogram[i];
+        if (count >= target)
+            return bucketValue(i);
+    }
+
+    return bucketValue(BucketCount - 1);
+}
+
+/**
+ * Starts listening on a random local port & returns the port number, or 0 on failure
+ */
+int StressSink::start()
+{
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this, &StressSink::onNewConnection);
+    if (!m_server->listen(QHostAddress::LocalHost, 0))
+        return 0;
+
+    return m_server->serverPort();
+}
+
+/**
+ * Accepts the connection of the communicator link
+ */
+void StressSink::onNewConnection()
+{
+    while (m_server->hasPendingConnections())
+    {
+        auto socket = m_server->nextPendingConnection();
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connect(socket, &QTcpSocket::readyRead, this, &StressSink::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, socket, &QTcpSocket::deleteLater);
+    }
+}
+
+/**
+ * Counts the received frames & registers their latency, frames may be split between
+ * several reads
+ */
+void StressSink::onReadyRead()
+{
+    auto socket = static_cast<QTcpSocket *>(sender());
+    m_buffer.append(socket->readAll());
+    const auto now = CLOCK.nsecsElapsed();
+    const auto measureFrom = MEASURE_FROM.load();
+
+    int start = 0;
+    int end = 0;
+    auto received = RECEIVED.load(std::memory_order_relaxed);
+    while ((end = m_buffer.indexOf(';', start)) >= 0)
+    {
+        // Skip separators & SIM commands
+        while (start < end && QChar::isSpace(m_buffer.at(start)))
+            ++start;
+
+        const auto length = end - start;
+        const auto frame = m_buffer.constData() + start;
+        const bool sim = length >= SIM_PREFIX_LENGTH
+                         && qstrncmp(frame, SIM_PREFIX, SIM_PREFIX_LENGTH) == 0;
+        start = end + 1;
+        if (sim)
+            continue;
+
+        // Register frame latency
+        if (received >= measureFrom)
+        {
+            const auto sent = SEND_TIMES[received % SEND_TIMES_SIZE].load();
+            ++m_histogram[bucket(now - sent)];
+            ++m_samples;
+        }
+
+        ++received;
+    }
+
+    m_buffer.remove(0, start);
+    RECEIVED.store(received);
+}
+
+/**
+ * Constructor function
+ */
+StressTest::StressTest()
+    : m_sink(nullptr)
+    , m_duration(DEFAULT_DURATION)
+    , m_linkAttempts(0)
+    , m_measuring(false)
+    , m_commandIndex(0)
+    , m_startTime(0)
+    , m_startCpuTime(0)
+    , m_startMemory(0)
+    , m_startFrames(0)
+    , m_endTime(0)
+    , m_endCpuTime(0)
+    , m_endMemory(0)
+    , m_endFrames(0)
+{
+    // Get test duration
+    foreach (const auto &argument, qApp->arguments())
+    {
+        if (argument.startsWith("--stress-duration="))
+            m_duration = qMax(1, argument.mid(18).toInt());
+    }
+
+    // Configure timers
+    m_sendTimer.setInterval(0);
+    m_linkTimer.setInterval(LINK_POLL_DELAY);
+    connect(&m_sendTimer, &QTimer::timeout, this, &StressTest::sendFrames);
+    connect(&m_linkTimer, &QTimer::timeout, this, &StressTest::waitForLink);
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+StressTest *StressTest::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new StressTest;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if the application was started in stress mode
+ */
+bool StressTest::requested()
+{
+    return qApp->arguments().contains("--stress")
+           || qApp->arguments().contains("--stress-save-baseline");
+}
+
+/**
+ * Returns the resident memory (in bytes) of the process
+ */
+qint64 StressTest::residentMemory()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return static_cast<qint64>(counters.WorkingSetSize);
+
+    return 0;
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&info), &count)
+        == KERN_SUCCESS)
+        return static_cast<qint64>(info.resident_size);
+
+    return 0;
+#else
+    QFile file("/proc/self/statm");
+    if (!file.open(QFile::ReadOnly))
+        return 0;
+
+    const auto fields = file.readAll().split(' ');
+    return fields.value(1).toLongLong() * sysconf(_SC_PAGESIZE);
+#endif
+}
+
+/**
+ * Replaces the communicator links with a link to the local sink & loads the synthetic
+ * simulation profile. The 1 Hz simulation ticks are disabled, all the simulation frames
+ * are generated by the stress test.
+ */
+void StressTest::start()
+{
+    LOG_INFO() << "Starting stress test," << m_duration << "s";
+    CLOCK.start();
+
+    // Start sink thread
+    int port = 0;
+    m_sink = new StressSink;
+    m_sink->moveToThread(&m_thread);
+    m_thread.setObjectName("Stress sink");
+    m_thread.start();
+    QMetaObject::invokeMethod(m_sink, "start", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(int, port));
+    if (port <= 0)
+    {
+        LOG_WARNING() << "Stress test: cannot start local sink";
+        qApp->exit(EXIT_FAILURE);
+        return;
+    }
+
+    // Replace links, the new link list is not saved
+    auto communicator = Communicator::getInstance();
+    auto te = Misc::TimerEvents::getInstance();
+    disconnect(te, &Misc::TimerEvents::timeout1Hz, communicator,
+               &Communicator::sendSimulatedData);
+    communicator->replaceLinks("127.0.0.1", static_cast<quint16>(port),
+                               Transport::Type::Tcp);
+
+    // Generate synthetic profile, pressure changes by 1 kPa/s between 70 & 100 kPa
+    const auto path = QDir::tempPath() + "/cc2021_stress_profile.csv";
+    QFile file(path);
+    if (file.open(QFile::WriteOnly))
+    {
+        for (int i = 0; i < PROFILE_ROWS; ++i)
+        {
+            const int pressure = 70000 + 1000 * qAbs(i % 60 - 30);
+            file.write(QString("CMD,$,SIMP,%1\n").arg(pressure).toUtf8());
+        }
+
+        file.close();
+    }
+
+    // Load & select profile, restart it when the simulation reaches its end
+    auto library = Mission::ProfileLibrary::getInstance();
+    const int index = library->load(path);
+    if (index < 0 || !library->profile(index)->valid)
+    {
+        LOG_WARNING() << "Stress test: cannot load synthetic profile";
+        qApp->exit(EXIT_FAILURE);
+        return;
+    }
+    communicator->selectProfile(index);
+    communicator->setProfileLoop(true);
+
+    // Wait for the link to connect
+    communicator->tryConnection();
+    m_linkTimer.start();
+}
+
+/**
+ * Generates frames until the number of frames in flight reaches its limit, stops the
+ * test when the measurement period ends
+ */
+void StressTest::sendFrames()
+{
+    // Begin measuring after the warm-up period
+    const auto elapsed = CLOCK.elapsed();
+    if (!m_measuring && elapsed >= WARMUP_DURATION)
+        beginMeasurement();
+
+    // Stop the test
+    if (m_measuring && elapsed - m_startTime / 1000000 >= m_duration * 1000)
+    {
+        endMeasurement();
+        return;
+    }
+
+    // Send frames, every BURST_PERIOD frames send a burst of commands
+    for (int i = 0; i < MAX_BATCH; ++i)
+    {
+        const auto sent = SENT.load();
+        if (sent - RECEIVED.load() >= MAX_IN_FLIGHT)
+            break;
+
+        if (!sendFrame(sent % BURST_PERIOD >= BURST_SIZE))
+        {
+            LOG_WARNING() << "Stress test: link to the sink was lost";
+            m_sendTimer.stop();
+            m_thread.quit();
+            m_thread.wait();
+            qApp->exit(EXIT_FAILURE);
+            return;
+        }
+    }
+}
+
+/**
+ * Enables & activates the simulation through the SIM commands & starts generating
+ * frames once the link with the sink is established
+ */
+void StressTest::waitForLink()
+{
+    auto communicator = Communicator::getInstance();
+    if (communicator->connectedToSerialStudio())
+    {
+        communicator->setSimulationMode(true);
+        communicator->setSimulationActivated(true);
+        if (!communicator->simulationActivated())
+        {
+            LOG_WARNING() << "Stress test: cannot activate the simulation";
+            m_linkTimer.stop();
+            m_thread.quit();
+            m_thread.wait();
+            qApp->exit(EXIT_FAILURE);
+            return;
+        }
+
+        m_linkTimer.stop();
+        CLOCK.restart();
+        m_sendTimer.start();
+        return;
+    }
+
+    if (++m_linkAttempts * LINK_POLL_DELAY >= LINK_TIMEOUT)
+    {
+        LOG_WARNING() << "Stress test: cannot connect to local sink";
+        m_linkTimer.stop();
+        m_thread.quit();
+        m_thread.wait();
+        qApp->exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Stops the sink, reports the results, compares them with the baseline & exits the
+ * application
+ */
+void StressTest::finish()
+{
+    // Stop sink
+    m_thread.quit();
+    m_thread.wait();
+
+    // Calculate results
+    const auto frames = qMax<qint64>(1, m_endFrames - m_startFrames);
+    const auto seconds = qMax<qint64>(1, m_endTime - m_startTime) / 1e9;
+    const double framesPerSecond = frames / seconds;
+    const auto cpuTime = static_cast<double>(m_endCpuTime - m_startCpuTime);
+    const double cpuPerFrame = cpuTime / frames;
+    const double memoryGrowth = (m_endMemory - m_startMemory) / 1024.0;
+    const double p50 = m_sink->percentile(0.50) / 1e3;
+    const double p99 = m_sink->percentile(0.99) / 1e3;
+    const double p999 = m_sink->percentile(0.999) / 1e3;
+    const double max = m_sink->percentile(1.0) / 1e3;
+
+    // Report results
+    LOG_INFO() << "Stress test results:" << frames << "frames in" << seconds << "s";
+    LOG_INFO() << "  Throughput:" << framesPerSecond << "frames/s";
+    LOG_INFO() << "  CPU time:" << cpuPerFrame << "us/frame";
+    LOG_INFO() << "  Memory growth:" << memoryGrowth << "KB";
+    LOG_INFO() << "  Latency: p50" << p50 << "us, p99" << p99 << "us, p99.9" << p999
+               << "us, max" << max << "us";
+
+    // Save results as the new baseline
+    QSettings settings;
+    settings.beginGroup("StressTest");
+    if (qApp->arguments().contains("--stress-save-baseline"))
+    {
+        settings.setValue("baselineFramesPerSecond", framesPerSecond);
+        settings.setValue("baselineCpuPerFrame", cpuPerFrame);
+        settings.setValue("baselineMemoryGrowth", memoryGrowth);
+        settings.setValue("baselineP99Latency", p99);
+        settings.endGroup();
+        LOG_INFO() << "Stress test baseline saved";
+        qApp->exit(EXIT_SUCCESS);
+        return;
+    }
+
+    // No baseline to compare with
+    if (!settings.contains("baselineFramesPerSecond"))
+    {
+        settings.endGroup();
+        LOG_WARNING() << "Stress test: no baseline saved,"
+                      << "run with --stress-save-baseline";
+        qApp->exit(EXIT_SUCCESS);
+        return;
+    }
+
+    // Compare results with the baseline
+    int regressions = 0;
+    const auto tolerance = settings.value("tolerance", DEFAULT_TOLERANCE).toDouble();
+    auto check = [&](const char *name, const double value, const double limit,
+                     const bool higherIsBetter) {
+        const bool failed = higherIsBetter ? value < limit : value > limit;
+        if (failed)
+        {
+            ++regressions;
+            LOG_WARNING() << "Stress test regression:" << name << value << "limit"
+                          << limit;
+        }
+    };
+
+    const auto baselineMemory = settings.value("baselineMemoryGrowth").toDouble();
+    check("frames/s", framesPerSecond,
+          settings.value("baselineFramesPerSecond").toDouble() * (1 - tolerance), true);
+    check("CPU us/frame", cpuPerFrame,
+          settings.value("baselineCpuPerFrame").toDouble() * (1 + tolerance), false);
+    check("memory growth KB", memoryGrowth,
+          qMax(baselineMemory * (1 + tolerance), baselineMemory + MIN_MEMORY_GROWTH),
+          false);
+    check("p99 latency us", p99,
+          settings.value("baselineP99Latency").toDouble() * (1 + tolerance), false);
+    settings.endGroup();
+
+    // Exit with the test result
+    if (regressions > 0)
+    {
+        LOG_WARNING() << "Stress test failed with" << regressions << "regressions";
+        qApp->exit(EXIT_FAILURE);
+    }
+
+    else
+    {
+        LOG_INFO() << "Stress test passed";
+        qApp->exit(EXIT_SUCCESS);
+    }
+}
+
+/**
+ * Generates a simulation frame (through the same path as the 1 Hz simulation ticks) or
+ * a command frame. Returns @c false if the frame could not be sent.
+ */
+bool StressTest::sendFrame(const bool simulation)
+{
+    auto communicator = Communicator::getInstance();
+    if (!communicator->connectedToSerialStudio())
+        return false;
+
+    // Register send time
+    const auto sent = SENT.load();
+    SEND_TIMES[sent % SEND_TIMES_SIZE].store(CLOCK.nsecsElapsed());
+    SENT.store(sent + 1);
+
+    // Send simulated pressure
+    if (simulation)
+        communicator->sendSimulatedData();
+
+    // Send command
+    else
+    {
+        communicator->sendStressFrame(COMMANDS[m_commandIndex]);
+        m_commandIndex = (m_commandIndex + 1) % COMMAND_COUNT;
+    }
+
+    return true;
+}
+
+/**
+ * Registers the initial state of the measurement
+ */
+void StressTest::beginMeasurement()
+{
+    m_measuring = true;
+    m_startTime = CLOCK.nsecsElapsed();
+    m_startFrames = RECEIVED.load();
+    m_startMemory = residentMemory();
+    m_startCpuTime = Misc::RenderStats::processCpuTime();
+    MEASURE_FROM.store(SENT.load());
+    LOG_INFO() << "Stress test warm-up finished";
+}
+
+/**
+ * Registers the final state of the measurement & waits for the sink to receive the
+ * frames that are still in flight
+ */
+void StressTest::endMeasurement()
+{
+    m_sendTimer.stop();
+    m_endTime = CLOCK.nsecsElapsed();
+    m_endFrames = RECEIVED.load();
+    m_endMemory = residentMemory();
+    m_endCpuTime = Misc::RenderStats::processCpuTime();
+    QTimer::singleShot(DRAIN_TIMEOUT, this, &StressTest::finish);
+}
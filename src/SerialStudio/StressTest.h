@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIALSTUDIO_STRESS_TEST_H
+#define SERIALSTUDIO_STRESS_TEST_H
+
+#include <atomic>
+
+#include <QTimer>
+#include <QThread>
+#include <QObject>
+#include <QTcpServer>
+
+namespace SerialStudio
+{
+/**
+ * Local TCP endpoint that receives the frames generated by the stress test. Runs in its
+ * own thread, counts the received frames (each frame ends with ';') & records the time
+ * elapsed since each frame was handed to the communicator in a latency histogram. The
+ * SIM commands that activate the simulation are not counted.
+ */
+class StressSink : public QObject
+{
+    Q_OBJECT
+
+public:
+    StressSink();
+
+    static const int BucketCount = 1024;
+    static int bucket(const qint64 nsecs);
+    static qint64 bucketValue(const int bucket);
+
+    qint64 percentile(const double fraction) const;
+
+public slots:
+    int start();
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+
+private:
+    QTcpServer *m_server;
+    QByteArray m_buffer;
+    quint64 m_samples;
+    quint64 m_histogram[BucketCount];
+};
+
+/**
+ * Throughput stress mode, started with the --stress command line argument.
+ *
+ * All the links are replaced by a single TCP link to a local sink & the communicator
+ * sends simulation frames from a synthetic profile, mixed with command bursts, as fast
+ * as the sink receives them. After a warm-up period, the test measures the sustained
+ * frames per second, the CPU time per frame, the growth of the resident memory & the
+ * latency from the moment a frame is generated until the sink receives it.
+ *
+ * Results are compared with the baseline stored in the settings, the application exits
+ * with a non-zero code if any result is worse than the baseline by more than the
+ * configured tolerance. Run with --stress-save-baseline to store the results as the
+ * new baseline, & with --stress-duration=<seconds> to change the test duration.
+ */
+class StressTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    static StressTest *getInstance();
+
+    static bool requested();
+    static qint64 residentMemory();
+
+public slots:
+    void start();
+
+private slots:
+    void sendFrames();
+    void waitForLink();
+    void finish();
+
+private:
+    StressTest();
+    bool sendFrame(const bool simulation);
+    void beginMeasurement();
+    void endMeasurement();
+
+private:
+    QThread m_thread;
+    StressSink *m_sink;
+    QTimer m_sendTimer;
+    QTimer m_linkTimer;
+
+    int m_duration;
+    int m_linkAttempts;
+    bool m_measuring;
+    int m_commandIndex;
+    qint64 m_startTime;
+    qint64 m_startCpuTime;
+    qint64 m_startMemory;
+    qint64 m_startFrames;
+    qint64 m_endTime;
+    qint64 m_endCpuTime;
+    qint64 m_endMemory;
+    qint64 m_endFrames;
+};
+}
+
+#endif
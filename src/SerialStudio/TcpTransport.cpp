@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "TcpTransport.h"
+
+#include <QSettings>
+
+using namespace SerialStudio;
+
+/*
+ * Default socket buffer sizes, can be changed through the application settings
+ */
+#define DEFAULT_SEND_BUFFER_SIZE    16 * 1024
+#define DEFAULT_RECEIVE_BUFFER_SIZE 64 * 1024
+
+/**
+ * Constructor function
+ */
+TcpTransport::TcpTransport(QObject *parent)
+    : Transport(parent)
+{
+    // Read buffer sizes
+    QSettings settings;
+    settings.beginGroup("TcpTransport");
+    m_sendBufferSize = settings.value("sendBufferSize", DEFAULT_SEND_BUFFER_SIZE).toInt();
+    m_receiveBufferSize
+        = settings.value("receiveBufferSize", DEFAULT_RECEIVE_BUFFER_SIZE).toInt();
+    settings.endGroup();
+
+    // Connect socket signals/slots
+    connect(&m_socket, &QTcpSocket::readyRead, this, &TcpTransport::onReadyRead);
+    connect(&m_socket, &QTcpSocket::connected, this, &TcpTransport::onConnected);
+    connect(&m_socket, &QTcpSocket::disconnected, this, &TcpTransport::onDisconnected);
+}
+
+/**
+ * Returns the transport type
+ */
+Transport::Type TcpTransport::type() const
+{
+    return Type::Tcp;
+}
+
+/**
+ * Returns @c true if the TCP connection is established
+ */
+bool TcpTransport::isConnected() const
+{
+    return m_socket.state() == QTcpSocket::ConnectedState;
+}
+
+/**
+ * Writes the given @a data & flushes the socket immediately instead of waiting for the
+ * next event loop iteration.
+ */
+qint64 TcpTransport::write(const QByteArray &data)
+{
+    auto bytes = m_socket.write(data);
+    m_socket.flush();
+    return bytes;
+}
+
+/**
+ * Starts a connection with the given @a host and @a port
+ */
+void TcpTransport::open(const QString &host, const quint16 port)
+{
+    m_socket.abort();
+    m_socket.connectToHost(host, port);
+}
+
+/**
+ * Aborts the connection
+ */
+void TcpTransport::close()
+{
+    m_socket.abort();
+}
+
+/**
+ * Configures the socket options & notifies the link
+ */
+void TcpTransport::onConnected()
+{
+    m_socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    m_socket.setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+    m_socket.setSocketOption(QAbstractSocket::SendBufferSizeSocketOption,
+                             m_sendBufferSize);
+    m_socket.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption,
+                             m_receiveBufferSize);
+
+    emit connectedChanged();
+}
+
+/**
+ * Closes the socket & notifies the link
+ */
+void TcpTransport::onDisconnected()
+{
+    m_socket.close();
+    emit connectedChanged();
+}
+
+/**
+ * Forwards received data to the link
+ */
+void TcpTransport::onReadyRead()
+{
+    emit dataReceived(m_socket.readAll());
+}
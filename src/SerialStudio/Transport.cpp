@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Transport.h"
+#include "TcpTransport.h"
+#include "UdpTransport.h"
+#include "LocalTransport.h"
+#include "LoopbackTransport.h"
+#include "SerialTransport.h"
+
+using namespace SerialStudio;
+
+/**
+ * Constructor function
+ */
+Transport::Transport(QObject *parent)
+    : QObject(parent)
+{
+}
+
+/**
+ * Returns the names of all the transports that can be used by a link
+ */
+QStringList Transport::availableTypes()
+{
+    QStringList list;
+    list.append(typeName(Type::Tcp));
+    list.append(typeName(Type::Udp));
+    list.append(typeName(Type::Local));
+    list.append(typeName(Type::Loopback));
+    list.append(typeName(Type::Serial));
+    return list;
+}
+
+/**
+ * Returns the name of the given transport @a type, used to save the link configuration
+ */
+QString Transport::typeName(const Type type)
+{
+    switch (type)
+    {
+        case Type::Udp:
+            return "UDP";
+        case Type::Local:
+            return "Local";
+        case Type::Loopback:
+            return "Loopback";
+        case Type::Serial:
+            return "Serial";
+        default:
+            return "TCP";
+    }
+}
+
+/**
+ * Returns the transport type that corresponds to the given @a name, TCP is used if the
+ * name is not recognized.
+ */
+Transport::Type Transport::typeFromName(const QString &name)
+{
+    if (name == typeName(Type::Udp))
+        return Type::Udp;
+    if (name == typeName(Type::Local))
+        return Type::Local;
+    if (name == typeName(Type::Loopback))
+        return Type::Loopback;
+    if (name == typeName(Type::Serial))
+        return Type::Serial;
+
+    return Type::Tcp;
+}
+
+/**
+ * Creates a new transport of the given @a type
+ */
+Transport *Transport::create(const Type type, QObject *parent)
+{
+    switch (type)
+    {
+        case Type::Udp:
+            return new UdpTransport(parent);
+        case Type::Local:
+            return new LocalTransport(parent);
+        case Type::Loopback:
+            return new LoopbackTransport(parent);
+        case Type::Serial:
+            return new SerialTransport(parent);
+        default:
+            return new TcpTransport(parent);
+    }
+}
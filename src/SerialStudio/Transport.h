@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIALSTUDIO_TRANSPORT_H
+#define SERIALSTUDIO_TRANSPORT_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QStringList>
+
+namespace SerialStudio
+{
+/**
+ * Abstract byte stream between a @c Link and a Serial Studio instance (or the ground
+ * station radio, when using a serial transport). Each subclass
+ * implements a different kind of connection, links only deal with this interface.
+ */
+class Transport : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void connectedChanged();
+    void dataReceived(const QByteArray &data);
+
+public:
+    enum class Type
+    {
+        Tcp,
+        Udp,
+        Local,
+        Loopback,
+        Serial,
+    };
+
+    explicit Transport(QObject *parent = nullptr);
+
+    virtual Type type() const = 0;
+    virtual bool isConnected() const = 0;
+    virtual qint64 write(const QByteArray &data) = 0;
+    virtual void open(const QString &host, const quint16 port) = 0;
+    virtual void close() = 0;
+
+    static QStringList availableTypes();
+    static QString typeName(const Type type);
+    static Type typeFromName(const QString &name);
+    static Transport *create(const Type type, QObject *parent = nullptr);
+};
+}
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "UdpTransport.h"
+
+using namespace SerialStudio;
+
+/*
+ * The remote endpoint is considered offline if no datagram arrives within this
+ * interval (in milliseconds)
+ */
+#define RX_TIMEOUT 3000
+
+/**
+ * Constructor function
+ */
+UdpTransport::UdpTransport(QObject *parent)
+    : Transport(parent)
+    , m_alive(false)
+    , m_port(0)
+{
+    m_timeout.setSingleShot(true);
+    m_timeout.setInterval(RX_TIMEOUT);
+    connect(&m_timeout, &QTimer::timeout, this, &UdpTransport::onTimeout);
+    connect(&m_socket, &QUdpSocket::readyRead, this, &UdpTransport::onReadyRead);
+    connect(&m_socket, &QUdpSocket::stateChanged, this, &UdpTransport::onStateChanged);
+}
+
+/**
+ * Returns the transport type
+ */
+Transport::Type UdpTransport::type() const
+{
+    return Type::Udp;
+}
+
+/**
+ * Returns @c true if the socket is associated with the remote endpoint & a datagram
+ * was received from it recently
+ */
+bool UdpTransport::isConnected() const
+{
+    return m_alive && m_socket.state() == QUdpSocket::ConnectedState;
+}
+
+/**
+ * Sends the given @a data as a single datagram
+ */
+qint64 UdpTransport::write(const QByteArray &data)
+{
+    return m_socket.write(data);
+}
+
+/**
+ * Associates the socket with the given @a host and @a port. UDP is connectionless, so
+ * this only fixes the default destination & filters incoming datagrams.
+ *
+ * The link calls this function periodically until the transport is connected, the
+ * socket is kept as-is while it is associated with the same endpoint & an empty
+ * datagram is sent again to announce the local endpoint.
+ */
+void UdpTransport::open(const QString &host, const quint16 port)
+{
+    if (m_socket.state() == QUdpSocket::ConnectedState && m_host == host
+        && m_port == port)
+    {
+        m_socket.write(QByteArray());
+        return;
+    }
+
+    m_host = host;
+    m_port = port;
+    setAlive(false);
+    m_socket.abort();
+    m_socket.connectToHost(host, port);
+}
+
+/**
+ * Closes the socket
+ */
+void UdpTransport::close()
+{
+    setAlive(false);
+    m_socket.abort();
+}
+
+/**
+ * Marks the remote endpoint as offline when it stops sending datagrams
+ */
+void UdpTransport::onTimeout()
+{
+    setAlive(false);
+}
+
+/**
+ * Reads all pending datagrams & forwards them to the link
+ */
+void UdpTransport::onReadyRead()
+{
+    while (m_socket.hasPendingDatagrams())
+    {
+        auto size = m_socket.pendingDatagramSize();
+        if (size < 0)
+            break;
+
+        m_datagram.resize(static_cast<int>(size));
+        auto bytes = m_socket.readDatagram(m_datagram.data(), size);
+        if (bytes < 0)
+            break;
+
+        // Remote endpoint is alive
+        m_timeout.start();
+        setAlive(true);
+
+        // Forward data to the link
+        if (bytes > 0)
+            emit dataReceived(m_datagram.left(static_cast<int>(bytes)));
+    }
+}
+
+/**
+ * Announces the local endpoint with an empty datagram once the socket is associated,
+ * so that the remote side knows where to send data. The traffic state is reset when
+ * the socket is disassociated.
+ */
+void UdpTransport::onStateChanged()
+{
+    if (m_socket.state() == QUdpSocket::ConnectedState)
+        m_socket.write(QByteArray());
+    else
+        setAlive(false);
+}
+
+/**
+ * Updates the traffic state & notifies the link when it changes
+ */
+void UdpTransport::setAlive(const bool alive)
+{
+    if (!alive)
+        m_timeout.stop();
+
+    if (m_alive != alive)
+    {
+        m_alive = alive;
+        emit connectedChanged();
+    }
+}
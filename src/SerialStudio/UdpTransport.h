@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIALSTUDIO_UDP_TRANSPORT_H
+#define SERIALSTUDIO_UDP_TRANSPORT_H
+
+#include <QTimer>
+#include <QUdpSocket>
+#include <SerialStudio/Transport.h>
+
+namespace SerialStudio
+{
+/**
+ * Sends each frame as a single UDP datagram, incoming datagrams from the remote
+ * endpoint are forwarded to the link.
+ *
+ * UDP has no handshake, so the transport is only reported as connected while datagrams
+ * keep arriving from the remote endpoint.
+ */
+class UdpTransport : public Transport
+{
+    Q_OBJECT
+
+public:
+    explicit UdpTransport(QObject *parent = nullptr);
+
+    Type type() const override;
+    bool isConnected() const override;
+    qint64 write(const QByteArray &data) override;
+    void open(const QString &host, const quint16 port) override;
+    void close() override;
+
+private slots:
+    void onTimeout();
+    void onReadyRead();
+    void onStateChanged();
+
+private:
+    void setAlive(const bool alive);
+
+private:
+    bool m_alive;
+    quint16 m_port;
+    QString m_host;
+    QTimer m_timeout;
+    QByteArray m_datagram;
+    QUdpSocket m_socket;
+};
+}
+
+#endif
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "XBee.h"
+
+#include <QSettings>
+
+using namespace SerialStudio;
+
+/*
+ * API frame delimiters & escaping
+ */
+#define START_DELIMITER 0x7E
+#define ESCAPE          0x7D
+#define XON             0x11
+#define XOFF            0x13
+#define ESCAPE_MASK     0x20
+
+/*
+ * Size of the transmit request fields that precede the RF data (frame type, frame ID,
+ * 64-bit address, 16-bit address, broadcast radius & options)
+ */
+#define TRANSMIT_REQUEST_HEADER 14
+
+/*
+ * Maximum RF payload of a single frame & resulting size of the encoded frame, in the
+ * worst case all the bytes after the start delimiter are escaped
+ */
+#define MAX_PAYLOAD_SIZE 256
+#define MAX_FRAME_SIZE   (1 + 2 * (2 + TRANSMIT_REQUEST_HEADER + MAX_PAYLOAD_SIZE + 1))
+
+/*
+ * Frames longer than this are considered corrupted
+ */
+#define MAX_FRAME_LENGTH 512
+
+/**
+ * Reads the radio configuration, addresses are stored as hexadecimal strings
+ */
+XBeeSettings XBeeSettings::load()
+{
+    QSettings settings;
+    settings.beginGroup("XBee");
+
+    XBeeSettings config;
+    config.apiMode = settings.value("apiMode", false).toBool();
+    config.escaped = settings.value("escaped", true).toBool();
+    config.containerAddress = XBeeBroadcastAddress;
+
+    bool ok = false;
+    auto address = settings.value("containerAddress").toString().toULongLong(&ok, 16);
+    if (ok && address != 0)
+        config.containerAddress = address;
+
+    const QStringList keys = {"containerAddress", "payload1Address", "payload2Address"};
+    foreach (const auto &key, keys)
+    {
+        address = settings.value(key).toString().toULongLong(&ok, 16);
+        if (ok && address != 0 && address != XBeeBroadcastAddress)
+            config.knownAddresses.append(address);
+    }
+
+    settings.endGroup();
+    return config;
+}
+
+/**
+ * Constructor function, set @a escaped to @c false for radios in API mode 1 (AP=1)
+ */
+XBeeEncoder::XBeeEncoder(const bool escaped)
+    : m_escaped(escaped)
+{
+    m_buffer.reserve(MAX_FRAME_SIZE);
+}
+
+/**
+ * Encodes a transmit request that sends the given @a data to the radio with the given
+ * 64-bit @a address. The radio answers with a transmit status frame with the same
+ * @a frameId, no status is reported if @a frameId is 0.
+ */
+const QByteArray &XBeeEncoder::transmitRequest(const quint8 frameId,
+                                               const quint64 address,
+                                               const QByteArray &data)
+{
+    // Reuse buffer if no link holds the previous frame
+    if (!m_buffer.isDetached())
+    {
+        m_buffer = QByteArray();
+        m_buffer.reserve(MAX_FRAME_SIZE);
+    }
+
+    // Start delimiter & frame length
+    const int length = TRANSMIT_REQUEST_HEADER + qMin(data.size(), MAX_PAYLOAD_SIZE);
+    m_buffer.resize(0);
+    m_buffer.append(static_cast<char>(START_DELIMITER));
+    append(static_cast<quint8>(length >> 8));
+    append(static_cast<quint8>(length & 0xFF));
+
+    // Frame header
+    quint8 sum = 0;
+    const quint8 header[TRANSMIT_REQUEST_HEADER]
+        = {XBeeFrameType::TransmitRequest,
+           frameId,
+           static_cast<quint8>(address >> 56),
+           static_cast<quint8>(address >> 48),
+           static_cast<quint8>(address >> 40),
+           static_cast<quint8>(address >> 32),
+           static_cast<quint8>(address >> 24),
+           static_cast<quint8>(address >> 16),
+           static_cast<quint8>(address >> 8),
+           static_cast<quint8>(address),
+           0xFF,
+           0xFE,
+           0x00,
+           0x00};
+    for (int i = 0; i < TRANSMIT_REQUEST_HEADER; ++i)
+    {
+        sum += header[i];
+        append(header[i]);
+    }
+
+    // RF data
+    for (int i = 0; i < length - TRANSMIT_REQUEST_HEADER; ++i)
+    {
+        const auto byte = static_cast<quint8>(data.at(i));
+        sum += byte;
+        append(byte);
+    }
+
+    // Checksum
+    append(0xFF - sum);
+    return m_buffer;
+}
+
+/**
+ * Appends the given @a byte to the frame, escaping it if needed
+ */
+void XBeeEncoder::append(const quint8 byte)
+{
+    if (m_escaped
+        && (byte == START_DELIMITER || byte == ESCAPE || byte == XON || byte == XOFF))
+    {
+        m_buffer.append(static_cast<char>(ESCAPE));
+        m_buffer.append(static_cast<char>(byte ^ ESCAPE_MASK));
+    }
+
+    else
+        m_buffer.append(static_cast<char>(byte));
+}
+
+/**
+ * Constructor function, set @a escaped to @c false for radios in API mode 1 (AP=1)
+ */
+XBeeDecoder::XBeeDecoder(const bool escaped)
+    : m_escaped(escaped)
+    , m_errors(0)
+{
+    m_frame.reserve(MAX_FRAME_LENGTH);
+    reset();
+}
+
+/**
+ * Discards the frame being decoded
+ */
+void XBeeDecoder::reset()
+{
+    m_state = State::WaitDelimiter;
+    m_escapeNext = false;
+    m_length = 0;
+    m_checksum = 0;
+    m_frame.resize(0);
+}
+
+/**
+ * Returns the number of corrupted frames that were discarded
+ */
+quint64 XBeeDecoder::errors() const
+{
+    return m_errors;
+}
+
+/**
+ * Decodes the received @a data & appends the complete frames to @a frames. Incomplete
+ * frames are kept until the rest of the data is received.
+ */
+void XBeeDecoder::decode(const QByteArray &data, QVector<XBeeFrame> &frames)
+{
+    for (int i = 0; i < data.size(); ++i)
+    {
+        auto byte = static_cast<quint8>(data.at(i));
+
+        // Start delimiter, in escaped mode it can only appear at the start of a frame
+        if (byte == START_DELIMITER && (m_escaped || m_state == State::WaitDelimiter))
+        {
+            if (m_state != State::WaitDelimiter)
+                ++m_errors;
+
+            reset();
+            m_state = State::LengthMsb;
+            continue;
+        }
+
+        // Discard data outside of a frame
+        if (m_state == State::WaitDelimiter)
+            continue;
+
+        // Unescape data
+        if (m_escaped)
+        {
+            if (byte == ESCAPE)
+            {
+                m_escapeNext = true;
+                continue;
+            }
+
+            if (m_escapeNext)
+            {
+                byte ^= ESCAPE_MASK;
+                m_escapeNext = false;
+            }
+        }
+
+        // Update frame
+        switch (m_state)
+        {
+            case State::LengthMsb:
+                m_length = byte << 8;
+                m_state = State::LengthLsb;
+                break;
+            case State::LengthLsb:
+                m_length |= byte;
+                m_state = State::FrameData;
+                if (m_length == 0 || m_length > MAX_FRAME_LENGTH)
+                {
+                    ++m_errors;
+                    reset();
+                }
+                break;
+            case State::FrameData:
+                m_checksum += byte;
+                m_frame.append(static_cast<char>(byte));
+                if (m_frame.size() == m_length)
+                    m_state = State::Checksum;
+                break;
+            case State::Checksum:
+                if (static_cast<quint8>(m_checksum + byte) == 0xFF)
+                    parseFrame(frames);
+                else
+                    ++m_errors;
+                reset();
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * Returns a user-friendly description of the delivery @a status of a transmit
+ * status frame
+ */
+QString XBeeDecoder::statusName(const quint8 status)
+{
+    switch (status)
+    {
+        case 0x00:
+            return tr("Delivered");
+        case 0x01:
+            return tr("MAC ACK failure");
+        case 0x02:
+            return tr("CCA failure");
+        case 0x21:
+            return tr("Network ACK failure");
+        case 0x22:
+            return tr("Not joined to network");
+        case 0x24:
+            return tr("Address not found");
+        case 0x25:
+            return tr("Route not found");
+        case 0x74:
+            return tr("Payload too large");
+        default:
+            return tr("Delivery error 0x%1").arg(status, 2, 16, QChar('0'));
+    }
+}
+
+/**
+ * Converts the frame with a valid checksum to a @c XBeeFrame, unsupported frame types
+ * are ignored
+ */
+void XBeeDecoder::parseFrame(QVector<XBeeFrame> &frames)
+{
+    const auto frame = reinterpret_cast<const quint8 *>(m_frame.constData());
+    const auto type = frame[0];
+
+    // Transmit status: type, frame ID, 16-bit address, retries, delivery & discovery
+    if (type == XBeeFrameType::TransmitStatus && m_length >= 7)
+    {
+        XBeeFrame status;
+        status.type = type;
+        status.frameId = frame[1];
+        status.retries = frame[4];
+        status.status = frame[5];
+        status.address = 0;
+        frames.append(status);
+    }
+
+    // Receive packet: type, 64-bit address, 16-bit address, options & RF data
+    else if (type == XBeeFrameType::ReceivePacket && m_length >= 12)
+    {
+        XBeeFrame packet;
+        packet.type = type;
+        packet.frameId = 0;
+        packet.retries = 0;
+        packet.status = 0;
+        packet.address = 0;
+        for (int i = 1; i <= 8; ++i)
+            packet.address = (packet.address << 8) | frame[i];
+
+        packet.data = m_frame.mid(12);
+        frames.append(packet);
+    }
+}
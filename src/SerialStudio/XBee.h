@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIALSTUDIO_XBEE_H
+#define SERIALSTUDIO_XBEE_H
+
+#include <QVector>
+#include <QString>
+#include <QByteArray>
+#include <QCoreApplication>
+
+namespace SerialStudio
+{
+/**
+ * API frame types used to talk with the XBee radios (Zigbee/DigiMesh frame set)
+ */
+namespace XBeeFrameType
+{
+enum
+{
+    TransmitRequest = 0x10,
+    TransmitStatus = 0x8B,
+    ReceivePacket = 0x90,
+};
+}
+
+/**
+ * 64-bit address used to broadcast a frame to all the radios of the network
+ */
+static const quint64 XBeeBroadcastAddress = 0x000000000000FFFF;
+
+/**
+ * Decoded XBee API frame. Only the fields that apply to the frame @a type are set:
+ * transmit status frames fill @a frameId, @a retries & @a status, while receive packets
+ * fill @a address & @a data.
+ */
+struct XBeeFrame
+{
+    quint8 type;
+    quint8 frameId;
+    quint8 retries;
+    quint8 status;
+    quint64 address;
+    QByteArray data;
+};
+
+/**
+ * XBee radio configuration, read from the "XBee" settings group
+ */
+struct XBeeSettings
+{
+    bool apiMode;
+    bool escaped;
+    quint64 containerAddress;
+    QVector<quint64> knownAddresses;
+
+    static XBeeSettings load();
+};
+
+/**
+ * Builds transmit request frames into a buffer that is allocated once & reused for
+ * every frame. When the links still hold the previous frame (e.g. a disconnected link
+ * queued it), a new buffer is allocated instead of modifying the queued frame.
+ */
+class XBeeEncoder
+{
+public:
+    explicit XBeeEncoder(const bool escaped = true);
+
+    const QByteArray &transmitRequest(const quint8 frameId, const quint64 address,
+                                      const QByteArray &data);
+
+private:
+    void append(const quint8 byte);
+
+private:
+    bool m_escaped;
+    QByteArray m_buffer;
+};
+
+/**
+ * Incremental API frame decoder, handles escaped bytes, validates checksums &
+ * re-synchronizes on the next start delimiter after a corrupted frame.
+ */
+class XBeeDecoder
+{
+    Q_DECLARE_TR_FUNCTIONS(XBeeDecoder)
+
+public:
+    explicit XBeeDecoder(const bool escaped = true);
+
+    void reset();
+    quint64 errors() const;
+    void decode(const QByteArray &data, QVector<XBeeFrame> &frames);
+
+    static QString statusName(const quint8 status);
+
+private:
+    void parseFrame(QVector<XBeeFrame> &frames);
+
+private:
+    enum class State
+    {
+        WaitDelimiter,
+        LengthMsb,
+        LengthLsb,
+        FrameData,
+        Checksum,
+    };
+
+    State m_state;
+    bool m_escaped;
+    bool m_escapeNext;
+    int m_length;
+    quint8 m_checksum;
+    quint64 m_errors;
+    QByteArray m_frame;
+};
+}
+
+#endif
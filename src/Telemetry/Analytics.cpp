@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Analytics.h"
+
+#include <QDateTime>
+#include <QStringList>
+#include <QVariantMap>
+#include <Logger.h>
+
+#include <Misc/TimerEvents.h>
+#include <SerialStudio/Communicator.h>
+
+using namespace Telemetry;
+
+/*
+ * Number of consecutive lost packets that are reported as a loss burst
+ */
+#define BURST_LENGTH 3
+
+/*
+ * If the packet count goes back more than this, we assume that the counter of the
+ * CanSat was reset instead of treating the packet as a late arrival
+ */
+#define RESET_THRESHOLD 1024
+
+/*
+ * Smoothing factor of the inter-arrival mean & jitter estimators (RFC 3550 uses 1/16)
+ */
+#define JITTER_GAIN (1.0 / 16.0)
+
+/*
+ * Interval (in seconds) between statistics reports in the log file
+ */
+#define LOG_INTERVAL 10
+
+/*
+ * Pointer to singleton instance of class
+ */
+static Analytics *INSTANCE = nullptr;
+
+/**
+ * Constructor function
+ */
+Analytics::Analytics()
+    : m_ticks(0)
+    , m_changed(false)
+{
+    reset();
+
+    auto te = Misc::TimerEvents::getInstance();
+    auto communicator = SerialStudio::Communicator::getInstance();
+    connect(te, &Misc::TimerEvents::timeout1Hz, this, &Analytics::onTimeout1Hz);
+    connect(communicator, &SerialStudio::Communicator::packetReceived, this,
+            &Analytics::process);
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+Analytics *Analytics::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new Analytics;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns a list with the statistics of each telemetry source, used by the QML interface
+ */
+QVariantList Analytics::sources() const
+{
+    QVariantList list;
+    const auto second = QDateTime::currentMSecsSinceEpoch() / 1000;
+    for (int i = 0; i < SourceCount; ++i)
+    {
+        const auto &stats = m_stats[i];
+
+        QVariantList histogram;
+        for (int j = 0; j < HistogramSize; ++j)
+            histogram.append(static_cast<double>(stats.histogram[j]));
+
+        QVariantMap map;
+        map.insert("name", Packet::sourceName(static_cast<Source>(i)));
+        map.insert("received", static_cast<double>(stats.received));
+        map.insert("lost", static_cast<double>(stats.lost));
+        map.insert("outOfOrder", static_cast<double>(stats.outOfOrder));
+        map.insert("lossRate", windowLossRate(stats, second) * 100);
+        map.insert("jitter", stats.jitter);
+        map.insert("lastGap", stats.lastGap);
+        map.insert("bursts", stats.bursts);
+        map.insert("longestBurst", stats.longestBurst);
+        map.insert("histogram", histogram);
+        list.append(map);
+    }
+
+    return list;
+}
+
+/**
+ * Clears the statistics of all sources
+ */
+void Analytics::reset()
+{
+    for (int i = 0; i < SourceCount; ++i)
+        resetStatistics(m_stats[i]);
+
+    emit statisticsChanged();
+}
+
+/**
+ * Writes a summary of the statistics of each source to the log file
+ */
+void Analytics::writeLog()
+{
+    const auto second = QDateTime::currentMSecsSinceEpoch() / 1000;
+    for (int i = 0; i < SourceCount; ++i)
+    {
+        const auto &stats = m_stats[i];
+        if (!stats.initialized)
+            continue;
+
+        QStringList histogram;
+        for (int j = 0; j < HistogramSize; ++j)
+            histogram.append(QString::number(stats.histogram[j]));
+
+        LOG_INFO() << "Telemetry" << Packet::sourceName(static_cast<Source>(i))
+                   << "received" << stats.received << "lost" << stats.lost
+                   << "loss (60 s)" << windowLossRate(stats, second) * 100 << "%"
+                   << "jitter" << stats.jitter << "ms"
+                   << "bursts" << stats.bursts << "gaps" << histogram.join('/');
+    }
+}
+
+/**
+ * Updates the statistics of the source of the given @a packet
+ */
+void Analytics::process(const Packet &packet)
+{
+    // Invalid packet
+    if (!packet.isValid())
+        return;
+
+    // Get source statistics & current window bucket
+    auto &stats = m_stats[static_cast<int>(packet.source())];
+    auto &current = bucket(stats, packet.timestamp() / 1000);
+    const auto count = packet.packetCount();
+    m_changed = true;
+
+    // First packet of this source (or packet counter reset)
+    if (!stats.initialized
+        || (count < stats.lastCount && stats.lastCount - count > RESET_THRESHOLD))
+    {
+        stats.initialized = true;
+        stats.lastCount = count;
+        stats.lastArrival = packet.timestamp();
+        ++stats.received;
+        ++current.received;
+        return;
+    }
+
+    // Late packet, it was already counted as lost
+    if (count <= stats.lastCount)
+    {
+        ++stats.received;
+        ++stats.outOfOrder;
+        ++current.received;
+        recoverLostPacket(stats, count);
+        return;
+    }
+
+    // Register gap
+    const quint32 gap = count - stats.lastCount - 1;
+    stats.lastGap = gap;
+    if (gap > 0)
+    {
+        stats.lost += gap;
+        current.lost += gap;
+        ++stats.histogram[histogramBin(gap)];
+
+        // Remember which bucket counted the gap, in case the packets arrive later
+        auto &record = stats.gaps[stats.nextGap];
+        record.first = stats.lastCount + 1;
+        record.last = count - 1;
+        record.second = current.second;
+        stats.nextGap = (stats.nextGap + 1) % GapHistorySize;
+
+        if (gap >= BURST_LENGTH)
+        {
+            ++stats.bursts;
+            stats.longestBurst = qMax(stats.longestBurst, gap);
+            LOG_WARNING() << "Telemetry" << Packet::sourceName(packet.source())
+                          << "lost a burst of" << gap << "packets";
+            emit burstDetected(packet.source(), gap);
+        }
+    }
+
+    // Update inter-arrival jitter, normalized to the interval of a single packet
+    const double interval = static_cast<double>(packet.timestamp() - stats.lastArrival)
+                            / (gap + 1);
+    if (stats.meanInterval <= 0)
+        stats.meanInterval = interval;
+    else
+    {
+        const double deviation = qAbs(interval - stats.meanInterval);
+        stats.meanInterval += (interval - stats.meanInterval) * JITTER_GAIN;
+        stats.jitter += (deviation - stats.jitter) * JITTER_GAIN;
+    }
+
+    // Update counters
+    ++stats.received;
+    ++current.received;
+    stats.lastCount = count;
+    stats.lastArrival = packet.timestamp();
+}
+
+/**
+ * Updates the user interface & periodically writes the statistics to the log file
+ */
+void Analytics::onTimeout1Hz()
+{
+    if (m_changed)
+    {
+        m_changed = false;
+        emit statisticsChanged();
+    }
+
+    if (++m_ticks >= LOG_INTERVAL)
+    {
+        m_ticks = 0;
+        writeLog();
+    }
+}
+
+/**
+ * Clears the given @a stats structure
+ */
+void Analytics::resetStatistics(Statistics &stats)
+{
+    stats.initialized = false;
+    stats.lastCount = 0;
+    stats.lastArrival = 0;
+    stats.received = 0;
+    stats.lost = 0;
+    stats.outOfOrder = 0;
+    stats.meanInterval = 0;
+    stats.jitter = 0;
+    stats.lastGap = 0;
+    stats.bursts = 0;
+    stats.longestBurst = 0;
+
+    for (int i = 0; i < WindowSize; ++i)
+    {
+        stats.window[i].second = -1;
+        stats.window[i].received = 0;
+        stats.window[i].lost = 0;
+    }
+
+    for (int i = 0; i < HistogramSize; ++i)
+        stats.histogram[i] = 0;
+
+    stats.nextGap = 0;
+    for (int i = 0; i < GapHistorySize; ++i)
+    {
+        stats.gaps[i].first = 0;
+        stats.gaps[i].last = 0;
+        stats.gaps[i].second = -1;
+    }
+}
+
+/**
+ * Returns the sliding window bucket that corresponds to the given @a second, buckets
+ * that belong to older seconds are recycled.
+ */
+Analytics::Bucket &Analytics::bucket(Statistics &stats, const qint64 second)
+{
+    auto &b = stats.window[second % WindowSize];
+    if (b.second != second)
+    {
+        b.second = second;
+        b.received = 0;
+        b.lost = 0;
+    }
+
+    return b;
+}
+
+/**
+ * Removes the late packet with the given @a count from the lost packets. The packet is
+ * also removed from the window bucket that counted its gap, as long as that bucket is
+ * still part of the sliding window.
+ */
+void Analytics::recoverLostPacket(Statistics &stats, const quint32 count)
+{
+    if (stats.lost > 0)
+        --stats.lost;
+
+    for (int i = 0; i < GapHistorySize; ++i)
+    {
+        const auto &gap = stats.gaps[i];
+        if (gap.second < 0 || count < gap.first || count > gap.last)
+            continue;
+
+        auto &b = stats.window[gap.second % WindowSize];
+        if (b.second == gap.second && b.lost > 0)
+            --b.lost;
+
+        return;
+    }
+}
+
+/**
+ * Returns the fraction of lost packets during the last @c WindowSize seconds
+ */
+double Analytics::windowLossRate(const Statistics &stats, const qint64 second) const
+{
+    quint64 lost = 0;
+    quint64 received = 0;
+    for (int i = 0; i < WindowSize; ++i)
+    {
+        const auto &b = stats.window[i];
+        if (b.second > second - WindowSize && b.second <= second)
+        {
+            lost += b.lost;
+            received += b.received;
+        }
+    }
+
+    if (lost + received == 0)
+        return 0;
+
+    return static_cast<double>(lost) / (lost + received);
+}
+
+/**
+ * Returns the histogram bin of the given @a gap size. Bins are: 1, 2, 3-4, 5-8, 9-16,
+ * 17-32 and more than 32 lost packets.
+ */
+int Analytics::histogramBin(const quint32 gap)
+{
+    int bin = 0;
+    quint32 limit = 1;
+    while (gap > limit && bin < HistogramSize - 1)
+    {
+        limit *= 2;
+        ++bin;
+    }
+
+    return bin;
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TELEMETRY_ANALYTICS_H
+#define TELEMETRY_ANALYTICS_H
+
+#include <QObject>
+#include <QVariantList>
+
+#include <Telemetry/Packet.h>
+
+namespace Telemetry
+{
+/**
+ * Streaming packet-loss analysis of the incoming telemetry. For each source, the class
+ * keeps the loss rate over a sliding window, a histogram of sequence gaps, the
+ * inter-arrival jitter & the number of loss bursts.
+ *
+ * All statistics are updated incrementally with fixed-size buffers, so memory usage
+ * does not depend on the duration of the flight.
+ */
+class Analytics : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(QVariantList sources
+               READ sources
+               NOTIFY statisticsChanged)
+    // clang-format on
+
+signals:
+    void statisticsChanged();
+    void burstDetected(const Telemetry::Source source, const quint32 length);
+
+public:
+    static Analytics *getInstance();
+
+    QVariantList sources() const;
+
+public slots:
+    void reset();
+    void writeLog();
+    void process(const Telemetry::Packet &packet);
+
+private slots:
+    void onTimeout1Hz();
+
+private:
+    Analytics();
+
+    static const int WindowSize = 60;
+    static const int HistogramSize = 7;
+    static const int GapHistorySize = 16;
+
+    struct Bucket
+    {
+        qint64 second;
+        quint32 received;
+        quint32 lost;
+    };
+
+    struct Gap
+    {
+        quint32 first;
+        quint32 last;
+        qint64 second;
+    };
+
+    struct Statistics
+    {
+        bool initialized;
+        quint32 lastCount;
+        qint64 lastArrival;
+
+        quint64 received;
+        quint64 lost;
+        quint64 outOfOrder;
+
+        double meanInterval;
+        double jitter;
+
+        quint32 lastGap;
+        quint32 bursts;
+        quint32 longestBurst;
+
+        Bucket window[WindowSize];
+        quint64 histogram[HistogramSize];
+
+        int nextGap;
+        Gap gaps[GapHistorySize];
+    };
+
+    void resetStatistics(Statistics &stats);
+    Bucket &bucket(Statistics &stats, const qint64 second);
+    void recoverLostPacket(Statistics &stats, const quint32 count);
+    double windowLossRate(const Statistics &stats, const qint64 second) const;
+    static int histogramBin(const quint32 gap);
+
+private:
+    int m_ticks;
+    bool m_changed;
+    Statistics m_stats[SourceCount];
+};
+}
+
+#endif
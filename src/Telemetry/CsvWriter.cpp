@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "CsvWriter.h"
+
+#include <QDir>
+#include <QUrl>
+#include <QSettings>
+#include <QDateTime>
+#include <QDesktopServices>
+#include <QCoreApplication>
+#include <Logger.h>
+
+#include <AppInfo.h>
+#include <SerialStudio/Communicator.h>
+
+#ifdef Q_OS_WIN
+#    include <io.h>
+#else
+#    include <unistd.h>
+#endif
+
+using namespace Telemetry;
+
+/*
+ * Size of the write buffer of each file, the buffer is handed to the writer thread when
+ * it grows beyond this size
+ */
+#define BUFFER_SIZE (64 * 1024)
+
+/*
+ * Default interval (in ms) between flushes to the storage device
+ */
+#define DEFAULT_SYNC_INTERVAL 1000
+
+/*
+ * Column headers defined by the CanSat 2021 mission guide
+ */
+static const char *CONTAINER_HEADER
+    = "TEAM_ID,MISSION_TIME,PACKET_COUNT,PACKET_TYPE,MODE,SP1_RELEASED,SP2_RELEASED,"
+      "ALTITUDE,TEMP,VOLTAGE,GPS_TIME,GPS_LATITUDE,GPS_LONGITUDE,GPS_ALTITUDE,GPS_SATS,"
+      "SOFTWARE_STATE,SP1_PACKET_COUNT,SP2_PACKET_COUNT,CMD_ECHO\n";
+static const char *PAYLOAD_HEADER = "TEAM_ID,MISSION_TIME,PACKET_COUNT,PACKET_TYPE,"
+                                    "SP_ALTITUDE,SP_TEMP,SP_ROTATION_RATE\n";
+
+/*
+ * Pointer to singleton instance of class
+ */
+static CsvWriter *INSTANCE = nullptr;
+
+/**
+ * Constructor function
+ */
+CsvFileWorker::CsvFileWorker()
+{
+    for (int i = 0; i < SourceCount; ++i)
+        m_files[i].dirty = false;
+}
+
+/**
+ * Forces the operating system to commit the flight files that were written since the
+ * last sync to the storage device
+ */
+void CsvFileWorker::sync()
+{
+    for (int i = 0; i < SourceCount; ++i)
+    {
+        auto &file = m_files[i];
+        if (!file.file.isOpen() || !file.dirty)
+            continue;
+
+#ifdef Q_OS_WIN
+        _commit(file.file.handle());
+#else
+        fsync(file.file.handle());
+#endif
+        file.dirty = false;
+    }
+}
+
+/**
+ * Syncs & closes the flight files
+ */
+void CsvFileWorker::closeFiles()
+{
+    sync();
+    for (int i = 0; i < SourceCount; ++i)
+    {
+        if (m_files[i].file.isOpen())
+        {
+            LOG_INFO() << "Closed" << m_files[i].file.fileName();
+            m_files[i].file.close();
+        }
+    }
+}
+
+/**
+ * Appends the given @a data to the file of the given @a source
+ */
+void CsvFileWorker::write(const int source, const QByteArray &data)
+{
+    auto &file = m_files[source];
+    if (!file.file.isOpen())
+        return;
+
+    const auto written = file.file.write(data);
+    if (written > 0)
+        file.dirty = true;
+
+    if (written != data.size())
+        emit errorOccurred(tr("Cannot write %1: %2, flight data was lost")
+                               .arg(file.file.fileName(), file.file.errorString()));
+}
+
+/**
+ * Opens the file of the given @a source at @a path without Qt buffering (the
+ * @c CsvWriter manages the write buffers) & writes the @a header to new files
+ */
+void CsvFileWorker::open(const int source, const QString &path, const QByteArray &header)
+{
+    auto &file = m_files[source];
+    if (file.file.isOpen())
+        file.file.close();
+
+    file.file.setFileName(path);
+    if (!file.file.open(QFile::WriteOnly | QFile::Append | QFile::Unbuffered))
+    {
+        emit errorOccurred(tr("Cannot open %1: %2").arg(path, file.file.errorString()));
+        return;
+    }
+
+    LOG_INFO() << "Writing flight data to" << path;
+    if (file.file.size() == 0)
+        write(source, header);
+}
+
+/**
+ * Constructor function, starts the writer thread
+ */
+CsvWriter::CsvWriter()
+    : m_worker(new CsvFileWorker)
+{
+    // Flight files are only written when the user enables them
+    QSettings settings;
+    settings.beginGroup("CsvWriter");
+    m_enabled = settings.value("enabled", false).toBool();
+    auto interval = settings.value("syncInterval", DEFAULT_SYNC_INTERVAL).toInt();
+    m_syncTimer.setInterval(interval);
+    settings.endGroup();
+
+    for (int i = 0; i < SourceCount; ++i)
+    {
+        m_outputs[i].open = false;
+        m_outputs[i].buffer.reserve(BUFFER_SIZE);
+    }
+
+    // Move file worker to writer thread
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &CsvFileWorker::deleteLater);
+    connect(m_worker, &CsvFileWorker::errorOccurred, this, &CsvWriter::onErrorOccurred);
+    m_thread.setObjectName("Flight files");
+    m_thread.start();
+
+    auto communicator = SerialStudio::Communicator::getInstance();
+    connect(&m_syncTimer, &QTimer::timeout, this, &CsvWriter::sync);
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &CsvWriter::shutdown);
+    connect(communicator, &SerialStudio::Communicator::packetReceived, this,
+            &CsvWriter::process);
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+CsvWriter *CsvWriter::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new CsvWriter;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if received packets are written to the flight files
+ */
+bool CsvWriter::enabled() const
+{
+    return m_enabled;
+}
+
+/**
+ * Returns the maximum time (in ms) that received data is kept in memory before it is
+ * synced to the storage device
+ */
+int CsvWriter::syncInterval() const
+{
+    return m_syncTimer.interval();
+}
+
+/**
+ * Returns the directory of the current flight files
+ */
+QString CsvWriter::directory() const
+{
+    return m_directory;
+}
+
+/**
+ * Returns the last error that caused flight data to be lost, or an empty string
+ */
+QString CsvWriter::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * Hands all the buffers to the writer thread & asks it to commit the flight files to
+ * the storage device
+ */
+void CsvWriter::sync()
+{
+    for (int i = 0; i < SourceCount; ++i)
+        writeBuffer(i);
+
+    QMetaObject::invokeMethod(m_worker, "sync", Qt::QueuedConnection);
+}
+
+/**
+ * Syncs & closes the flight files, the next packet starts a new flight directory
+ */
+void CsvWriter::closeFiles()
+{
+    for (int i = 0; i < SourceCount; ++i)
+    {
+        writeBuffer(i);
+        m_outputs[i].open = false;
+    }
+
+    m_syncTimer.stop();
+    QMetaObject::invokeMethod(m_worker, "closeFiles", Qt::QueuedConnection);
+
+    m_directory.clear();
+    emit directoryChanged();
+}
+
+/**
+ * Opens the directory of the current flight files (or the parent directory of all
+ * flights) with the system file manager
+ */
+void CsvWriter::openDirectory()
+{
+    auto path = m_directory.isEmpty() ? FLIGHT_DATA_DIR : m_directory;
+    QDir().mkpath(path);
+    QDesktopServices::openUrl(QUrl::fromLocalFile(path));
+}
+
+/**
+ * Enables or disables writing the flight files
+ */
+void CsvWriter::setEnabled(const bool enabled)
+{
+    if (m_enabled != enabled)
+    {
+        if (!enabled)
+            closeFiles();
+
+        m_enabled = enabled;
+        QSettings().setValue("CsvWriter/enabled", enabled);
+        emit enabledChanged();
+    }
+}
+
+/**
+ * Changes the maximum time (in ms) that data is kept in memory before being synced
+ */
+void CsvWriter::setSyncInterval(const int interval)
+{
+    if (interval > 0 && interval != syncInterval())
+    {
+        m_syncTimer.setInterval(interval);
+        QSettings().setValue("CsvWriter/syncInterval", interval);
+        emit syncIntervalChanged();
+    }
+}
+
+/**
+ * Appends the given telemetry @a packet to the file of its source
+ */
+void CsvWriter::process(const Telemetry::Packet &packet)
+{
+    // Nothing to do
+    if (!m_enabled || !packet.isValid())
+        return;
+
+    // Open file on first packet
+    const auto source = static_cast<int>(packet.source());
+    auto &output = m_outputs[source];
+    if (!output.open && !openFile(source))
+        return;
+
+    // Add packet to buffer
+    output.buffer.append(packet.raw());
+    output.buffer.append('\n');
+
+    // Write full buffers
+    if (output.buffer.size() >= BUFFER_SIZE)
+        writeBuffer(source);
+}
+
+/**
+ * Syncs & closes the flight files before the application exits, waiting for the writer
+ * thread to process the last buffers
+ */
+void CsvWriter::shutdown()
+{
+    for (int i = 0; i < SourceCount; ++i)
+    {
+        writeBuffer(i);
+        m_outputs[i].open = false;
+    }
+
+    m_syncTimer.stop();
+    QMetaObject::invokeMethod(m_worker, "closeFiles", Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+}
+
+/**
+ * Logs the given write @a error & shows it to the user
+ */
+void CsvWriter::onErrorOccurred(const QString &error)
+{
+    LOG_WARNING() << error;
+    if (m_errorString != error)
+    {
+        m_errorString = error;
+        emit errorStringChanged();
+    }
+}
+
+/**
+ * Creates the flight directory (if needed) & asks the writer thread to open the file
+ * for the given @a source
+ */
+bool CsvWriter::openFile(const int source)
+{
+    // Create flight directory, a new flight starts without errors
+    if (m_directory.isEmpty())
+    {
+        auto date = QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss");
+        auto path = QString("%1/%2").arg(FLIGHT_DATA_DIR, date);
+        if (!QDir().mkpath(path))
+        {
+            onErrorOccurred(tr("Cannot create flight directory %1").arg(path));
+            setEnabled(false);
+            return false;
+        }
+
+        m_directory = path;
+        m_syncTimer.start();
+        emit directoryChanged();
+
+        if (!m_errorString.isEmpty())
+        {
+            m_errorString.clear();
+            emit errorStringChanged();
+        }
+    }
+
+    // Open file in the writer thread
+    auto name = Packet::sourceName(static_cast<Source>(source));
+    if (name != "C")
+        name = "SP" + name.mid(1);
+
+    const bool container = source == static_cast<int>(Source::Container);
+    const QByteArray header = container ? CONTAINER_HEADER : PAYLOAD_HEADER;
+    const auto path = QString("%1/Flight_1714_%2.csv").arg(m_directory, name);
+    QMetaObject::invokeMethod(m_worker, "open", Qt::QueuedConnection, Q_ARG(int, source),
+                              Q_ARG(QString, path), Q_ARG(QByteArray, header));
+
+    m_outputs[source].open = true;
+    m_outputs[source].buffer.resize(0);
+    return true;
+}
+
+/**
+ * Hands the buffer of the given @a source to the writer thread & starts a new buffer,
+ * the writer thread reports the data that it cannot write.
+ */
+void CsvWriter::writeBuffer(const int source)
+{
+    auto &output = m_outputs[source];
+    if (!output.open || output.buffer.isEmpty())
+        return;
+
+    QMetaObject::invokeMethod(m_worker, "write", Qt::QueuedConnection,
+                              Q_ARG(int, source), Q_ARG(QByteArray, output.buffer));
+
+    output.buffer = QByteArray();
+    output.buffer.reserve(BUFFER_SIZE);
+}
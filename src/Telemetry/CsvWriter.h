@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TELEMETRY_CSV_WRITER_H
+#define TELEMETRY_CSV_WRITER_H
+
+#include <QFile>
+#include <QTimer>
+#include <QThread>
+#include <QObject>
+
+#include <Telemetry/Packet.h>
+
+namespace Telemetry
+{
+/**
+ * Owns the flight files in the writer thread of the @c CsvWriter, so that writes &
+ * syncs to a slow storage device do not block the user interface. All the file
+ * operations are invoked through queued calls.
+ */
+class CsvFileWorker : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void errorOccurred(const QString &error);
+
+public:
+    CsvFileWorker();
+
+public slots:
+    void sync();
+    void closeFiles();
+    void write(const int source, const QByteArray &data);
+    void open(const int source, const QString &path, const QByteArray &header);
+
+private:
+    struct File
+    {
+        QFile file;
+        bool dirty;
+    };
+
+    File m_files[SourceCount];
+};
+
+/**
+ * Writes the received telemetry packets to the competition flight files, one CSV file
+ * per source (Flight_1714_C.csv, Flight_1714_SP1.csv & Flight_1714_SP2.csv).
+ *
+ * Packets are appended to a fixed-size buffer for each file, full buffers are handed
+ * to the writer thread, which also syncs the files that changed to the storage device
+ * every @c syncInterval milliseconds. Memory usage does not depend on the flight
+ * duration, and a crash loses at most the data received during the last sync interval.
+ *
+ * Write errors are reported through the @c errorString property, so that the user
+ * knows that flight data is being lost.
+ */
+class CsvWriter : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(int syncInterval
+               READ syncInterval
+               WRITE setSyncInterval
+               NOTIFY syncIntervalChanged)
+    Q_PROPERTY(QString directory
+               READ directory
+               NOTIFY directoryChanged)
+    Q_PROPERTY(QString errorString
+               READ errorString
+               NOTIFY errorStringChanged)
+    // clang-format on
+
+signals:
+    void enabledChanged();
+    void directoryChanged();
+    void errorStringChanged();
+    void syncIntervalChanged();
+
+public:
+    static CsvWriter *getInstance();
+
+    bool enabled() const;
+    int syncInterval() const;
+    QString directory() const;
+    QString errorString() const;
+
+public slots:
+    void sync();
+    void closeFiles();
+    void openDirectory();
+    void setEnabled(const bool enabled);
+    void setSyncInterval(const int interval);
+    void process(const Telemetry::Packet &packet);
+
+private slots:
+    void shutdown();
+    void onErrorOccurred(const QString &error);
+
+private:
+    CsvWriter();
+
+    bool openFile(const int source);
+    void writeBuffer(const int source);
+
+private:
+    struct Output
+    {
+        bool open;
+        QByteArray buffer;
+    };
+
+    bool m_enabled;
+    QTimer m_syncTimer;
+    QString m_directory;
+    QString m_errorString;
+    Output m_outputs[SourceCount];
+
+    QThread m_thread;
+    CsvFileWorker *m_worker;
+};
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Packet.h"
+
+#include <QString>
+
+using namespace Telemetry;
+
+/**
+ * Constructor function, creates an invalid packet
+ */
+Packet::Packet()
+    : m_valid(false)
+    , m_source(Source::Unknown)
+    , m_packetCount(0)
+    , m_timestamp(0)
+{
+}
+
+/**
+ * Returns @c true if the packet contains the common telemetry header
+ */
+bool Packet::isValid() const
+{
+    return m_valid;
+}
+
+/**
+ * Returns the device that generated the packet
+ */
+Source Packet::source() const
+{
+    return m_source;
+}
+
+/**
+ * Returns the PACKET_COUNT field of the packet
+ */
+quint32 Packet::packetCount() const
+{
+    return m_packetCount;
+}
+
+/**
+ * Returns the time (in ms since epoch) in which the packet was received
+ */
+qint64 Packet::timestamp() const
+{
+    return m_timestamp;
+}
+
+/**
+ * Returns the packet line as it was received, without line terminators
+ */
+const QByteArray &Packet::raw() const
+{
+    return m_raw;
+}
+
+/**
+ * Returns all the comma-separated fields of the packet
+ */
+const QList<QByteArray> &Packet::fields() const
+{
+    return m_fields;
+}
+
+/**
+ * Returns the field at the given @a index, or an empty byte array if the packet does
+ * not contain such field.
+ */
+QByteArray Packet::field(const int index) const
+{
+    if (index >= 0 && index < m_fields.count())
+        return m_fields.at(index);
+
+    return QByteArray();
+}
+
+/**
+ * Returns the PACKET_TYPE string that corresponds to the given @a source
+ */
+QString Packet::sourceName(const Source source)
+{
+    switch (source)
+    {
+        case Source::Container:
+            return "C";
+        case Source::Payload1:
+            return "S1";
+        case Source::Payload2:
+            return "S2";
+        default:
+            return "?";
+    }
+}
+
+/**
+ * Splits the given telemetry @a line and validates the common packet header. The
+ * @a timestamp is stored with the packet so that every module that processes it
+ * agrees on the reception time.
+ */
+Packet Packet::fromLine(const QByteArray &line, const qint64 timestamp)
+{
+    Packet packet;
+    packet.m_raw = line;
+    packet.m_timestamp = timestamp;
+    packet.m_fields = line.split(',');
+
+    // Not enough fields to contain a telemetry header
+    if (packet.m_fields.count() <= ContainerField::PacketType)
+        return packet;
+
+    // Commands echoed by Serial Studio are not telemetry packets
+    if (packet.m_fields.at(ContainerField::TeamId) != "1714")
+        return packet;
+
+    // Get packet source
+    auto type = packet.m_fields.at(ContainerField::PacketType).trimmed();
+    if (type == "C")
+        packet.m_source = Source::Container;
+    else if (type == "S1")
+        packet.m_source = Source::Payload1;
+    else if (type == "S2")
+        packet.m_source = Source::Payload2;
+    else
+        return packet;
+
+    // Get packet count
+    bool ok = false;
+    auto count = packet.m_fields.at(ContainerField::PacketCount).trimmed();
+    packet.m_packetCount = count.toUInt(&ok);
+    packet.m_valid = ok;
+    return packet;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TELEMETRY_PACKET_H
+#define TELEMETRY_PACKET_H
+
+#include <QList>
+#include <QByteArray>
+
+namespace Telemetry
+{
+/**
+ * Origin of a telemetry packet, obtained from the PACKET_TYPE field
+ */
+enum class Source
+{
+    Unknown = -1,
+    Container = 0,
+    Payload1 = 1,
+    Payload2 = 2,
+};
+
+/**
+ * Number of valid telemetry sources, useful for per-source lookup tables
+ */
+static const int SourceCount = 3;
+
+/**
+ * Field indexes of the container telemetry packets
+ */
+namespace ContainerField
+{
+enum
+{
+    TeamId = 0,
+    MissionTime = 1,
+    PacketCount = 2,
+    PacketType = 3,
+    Mode = 4,
+    Sp1Released = 5,
+    Sp2Released = 6,
+    Altitude = 7,
+    Temperature = 8,
+    Voltage = 9,
+    GpsTime = 10,
+    GpsLatitude = 11,
+    GpsLongitude = 12,
+    GpsAltitude = 13,
+    GpsSats = 14,
+    SoftwareState = 15,
+    Sp1PacketCount = 16,
+    Sp2PacketCount = 17,
+    CmdEcho = 18,
+};
+}
+
+/**
+ * Field indexes of the science payload telemetry packets
+ */
+namespace PayloadField
+{
+enum
+{
+    TeamId = 0,
+    MissionTime = 1,
+    PacketCount = 2,
+    PacketType = 3,
+    Altitude = 4,
+    Temperature = 5,
+    RotationRate = 6,
+};
+}
+
+/**
+ * Decoded telemetry packet, as defined by the CanSat 2021 mission guide:
+ *
+ * TEAM_ID,MISSION_TIME,PACKET_COUNT,PACKET_TYPE,...
+ *
+ * The remaining fields depend on the packet type and are kept as raw byte arrays, they
+ * are only converted to numbers by the modules that need them.
+ */
+class Packet
+{
+public:
+    Packet();
+
+    bool isValid() const;
+    Source source() const;
+    quint32 packetCount() const;
+    qint64 timestamp() const;
+    const QByteArray &raw() const;
+    const QList<QByteArray> &fields() const;
+    QByteArray field(const int index) const;
+
+    static QString sourceName(const Source source);
+    static Packet fromLine(const QByteArray &line, const qint64 timestamp);
+
+private:
+    bool m_valid;
+    Source m_source;
+    quint32 m_packetCount;
+    qint64 m_timestamp;
+    QByteArray m_raw;
+    QList<QByteArray> m_fields;
+};
+}
+
+#endif
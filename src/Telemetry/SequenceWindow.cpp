@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "SequenceWindow.h"
+
+using namespace Telemetry;
+
+/*
+ * Number of packet counts remembered below the highest received packet count
+ */
+#define WINDOW_SIZE 64
+
+/*
+ * Time (in ms) without accepted packets after which an old packet count is considered
+ * a counter reset. Copies of a packet received through other links arrive well within
+ * this time, while a processor restart interrupts the 1 Hz telemetry for longer.
+ */
+#define RESET_TIMEOUT 2500
+
+/**
+ * Constructor function
+ */
+SequenceWindow::SequenceWindow()
+{
+    reset();
+}
+
+/**
+ * Forgets all the packet counts registered so far
+ */
+void SequenceWindow::reset()
+{
+    m_mask = 0;
+    m_highest = 0;
+    m_lastAccepted = 0;
+    m_initialized = false;
+}
+
+/**
+ * Registers the given @a sequence number, received at the given @a time (in ms), and
+ * returns @c true if it was not seen before, or @c false if the packet is a duplicate.
+ */
+bool SequenceWindow::accept(const quint32 sequence, const qint64 time)
+{
+    // First packet or counter reset after a silent period
+    if (!m_initialized
+        || (sequence <= m_highest && time - m_lastAccepted >= RESET_TIMEOUT))
+    {
+        restart(sequence, time);
+        return true;
+    }
+
+    // Newer packet, slide the window
+    if (sequence > m_highest)
+    {
+        const quint32 shift = sequence - m_highest;
+        if (shift >= WINDOW_SIZE)
+            m_mask = 1;
+        else
+            m_mask = (m_mask << shift) | 1;
+
+        m_highest = sequence;
+        m_lastAccepted = time;
+        return true;
+    }
+
+    // Packet is older than the window, the packet counter was reset
+    const quint32 diff = m_highest - sequence;
+    if (diff >= WINDOW_SIZE)
+    {
+        restart(sequence, time);
+        return true;
+    }
+
+    // Packet is inside the window, check if we already received it
+    const quint64 bit = Q_UINT64_C(1) << diff;
+    if (m_mask & bit)
+        return false;
+
+    m_mask |= bit;
+    m_lastAccepted = time;
+    return true;
+}
+
+/**
+ * Restarts the window at the given @a sequence number
+ */
+void SequenceWindow::restart(const quint32 sequence, const qint64 time)
+{
+    m_mask = 1;
+    m_highest = sequence;
+    m_lastAccepted = time;
+    m_initialized = true;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TELEMETRY_SEQUENCE_WINDOW_H
+#define TELEMETRY_SEQUENCE_WINDOW_H
+
+#include <QtGlobal>
+
+namespace Telemetry
+{
+/**
+ * Sliding window of recently seen packet counts, used to discard the copies of a
+ * packet that arrive through more than one ground station link.
+ *
+ * The window remembers the highest packet count received & a bitmask with the previous
+ * 64 packet counts, so memory usage & lookup cost are constant.
+ *
+ * A reset of the packet counter (e.g. after the CanSat processor restarts) is detected
+ * when a packet count falls behind the window, or when an old packet count arrives
+ * after the source was silent for a while. Both cases restart the window instead of
+ * discarding the packets.
+ */
+class SequenceWindow
+{
+public:
+    SequenceWindow();
+
+    void reset();
+    bool accept(const quint32 sequence, const qint64 time);
+
+private:
+    void restart(const quint32 sequence, const qint64 time);
+
+private:
+    bool m_initialized;
+    quint32 m_highest;
+    quint64 m_mask;
+    qint64 m_lastAccepted;
+};
+}
+
+#endif
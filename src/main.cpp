@@ -20,9 +20,13 @@
  * THE SOFTWARE.
  */
 
+#include <memory>
+
 #include <QtQml>
 #include <QSysInfo>
+#include <QTranslator>
 #include <QQuickStyle>
+#include <QQuickWindow>
 #include <QApplication>
 #include <QStyleFactory>
 #include <QQmlApplicationEngine>
@@ -36,12 +40,113 @@
 #include <AppInfo.h>
 #include <Misc/Utilities.h>
 #include <Misc/TimerEvents.h>
+#include <Misc/Metrics.h>
+#include <Misc/Profiler.h>
+#include <Misc/LogViewer.h>
+#include <Misc/RenderStats.h>
+#include <Misc/StartupTrace.h>
+#include <Misc/Watchdog.h>
+#include <Mission/ProfileLibrary.h>
+#include <Mission/RuleEngine.h>
+#include <Mission/Timeline.h>
 #include <SerialStudio/Communicator.h>
+#include <SerialStudio/CommandTracker.h>
+#include <SerialStudio/SessionRecorder.h>
+#include <SerialStudio/StressTest.h>
+#include <Telemetry/Analytics.h>
+#include <Telemetry/CsvWriter.h>
 
 #ifdef Q_OS_WIN
 #    include <windows.h>
 #endif
 
+/*
+ * Time (in ms) between the first frame and the initialization of non-critical modules
+ */
+#define DEFERRED_INIT_DELAY 250
+
+/*
+ * Time (in ms) between the first frame and the end of the startup trace, this gives the
+ * application a chance to register the first connection with Serial Studio
+ */
+#define STARTUP_TRACE_DURATION 5000
+
+/**
+ * Loads the translations for the system language & retranslates the QML interface.
+ * Translations are not needed to show the first frame, so they are loaded together
+ * with the other non-critical modules.
+ */
+static void loadTranslations(QQmlApplicationEngine *engine)
+{
+    if (QLocale().language() != QLocale::English)
+    {
+        auto translator = new QTranslator(qApp);
+        if (translator->load(QLocale(), "", "", ":/translations", ".qm"))
+        {
+            qApp->installTranslator(translator);
+            engine->retranslate();
+        }
+
+        else
+            delete translator;
+    }
+}
+
+/**
+ * Creates the modules that process the received telemetry (session archive, flight
+ * files, analytics & automation rules) as soon as the first frame is shown, so that
+ * they miss as little telemetry as possible.
+ */
+static void initTelemetryModules(QQmlApplicationEngine *engine)
+{
+    auto c = engine->rootContext();
+    auto trace = Misc::StartupTrace::getInstance();
+    c->setContextProperty("Cpp_SerialStudio_SessionRecorder",
+                          SerialStudio::SessionRecorder::getInstance());
+    c->setContextProperty("Cpp_Telemetry_Analytics", Telemetry::Analytics::getInstance());
+    c->setContextProperty("Cpp_Telemetry_CsvWriter", Telemetry::CsvWriter::getInstance());
+    c->setContextProperty("Cpp_Mission_RuleEngine", Mission::RuleEngine::getInstance());
+    trace->mark("Telemetry modules created");
+}
+
+/**
+ * Initializes the modules that are not needed to display the user interface or to
+ * communicate with Serial Studio, such as the software updater, the translations & the
+ * diagnostic tools. Each module is exposed to the QML interface only after it has been
+ * created, the windows that use them are created afterwards.
+ */
+static void initDeferredModules(QQmlApplicationEngine *engine)
+{
+    auto c = engine->rootContext();
+    auto trace = Misc::StartupTrace::getInstance();
+
+    // Create diagnostic & mission modules
+    c->setContextProperty("Cpp_Misc_Metrics", Misc::Metrics::getInstance());
+    c->setContextProperty("Cpp_Misc_LogViewer", Misc::LogViewer::getInstance());
+    c->setContextProperty("Cpp_Misc_Watchdog", Misc::Watchdog::getInstance());
+    c->setContextProperty("Cpp_Mission_Timeline", Mission::Timeline::getInstance());
+    c->setContextProperty("Cpp_Mission_ProfileLibrary",
+                          Mission::ProfileLibrary::getInstance());
+    trace->mark("Deferred modules created");
+
+    // Load translations
+    loadTranslations(engine);
+    trace->mark("Translations loaded");
+
+    // Configure the updater
+    LOG_INFO() << "Configuring QSimpleUpdater...";
+    auto updater = QSimpleUpdater::getInstance();
+    updater->setNotifyOnUpdate(APP_UPDATER_URL, true);
+    updater->setNotifyOnFinish(APP_UPDATER_URL, false);
+    updater->setMandatoryUpdate(APP_UPDATER_URL, false);
+    c->setContextProperty("Cpp_Updater", updater);
+    LOG_INFO() << "QSimpleUpdater configuration finished!";
+    trace->mark("Updater configured");
+
+    // Create the windows of the deferred modules
+    c->setContextProperty("Cpp_ModulesReady", true);
+}
+
 /**
  * @brief Entry-point function of the application
  *
@@ -52,6 +157,9 @@
  */
 int main(int argc, char **argv)
 {
+    // Start measuring startup time
+    auto trace = Misc::StartupTrace::getInstance();
+
     // Fix console output on Windows (https://stackoverflow.com/a/41701133)
     // This code will only execute if the application is started from the comamnd prompt
 #ifdef _WIN32
@@ -75,6 +183,7 @@ int main(int argc, char **argv)
     app.setApplicationVersion(APP_VERSION);
     app.setOrganizationName(APP_DEVELOPER);
     app.setOrganizationDomain(APP_SUPPORT_URL);
+    trace->mark("Application created");
 
     // Configure CuteLogger
     auto fileAppender = new FileAppender;
@@ -84,39 +193,64 @@ int main(int argc, char **argv)
     consoleAppender->setFormat(LOG_FORMAT);
     cuteLogger->registerAppender(fileAppender);
     cuteLogger->registerAppender(consoleAppender);
+    trace->setLoggerReady();
 
     // Begin logging
     LOG_INFO() << QDateTime::currentDateTime();
     LOG_INFO() << APP_NAME << APP_VERSION;
     LOG_INFO() << "Running on" << QSysInfo::prettyProductName().toStdString().c_str();
+    trace->mark("Logger configured");
 
-    // Init application modules
+    // Init the modules needed for the first frame & the first connection, the other
+    // modules are created by initTelemetryModules() & initDeferredModules()
     QQmlApplicationEngine engine;
-    auto updater = QSimpleUpdater::getInstance();
     auto utilities = Misc::Utilities::getInstance();
     auto timerEvents = Misc::TimerEvents::getInstance();
+    auto renderStats = Misc::RenderStats::getInstance();
     auto ssCommunicator = SerialStudio::Communicator::getInstance();
+    auto ssCommandTracker = SerialStudio::CommandTracker::getInstance();
 
     // Log status
     LOG_INFO() << "Finished creating application modules";
+    trace->mark("Modules created");
+
+    // Start connecting to Serial Studio while the QML interface loads, the stress test
+    // replaces all the links with a local sink
+    if (!SerialStudio::StressTest::requested())
+        ssCommunicator->tryConnection();
 
-    // Init QML interface
+    // Init QML interface, the deferred modules are registered later
     auto c = engine.rootContext();
     QQuickStyle::setStyle("Universal");
-    c->setContextProperty("Cpp_Updater", updater);
+    c->setContextProperty("Cpp_Updater", nullptr);
+    c->setContextProperty("Cpp_ModulesReady", false);
+    c->setContextProperty("Cpp_Misc_Metrics", nullptr);
+    c->setContextProperty("Cpp_Misc_LogViewer", nullptr);
+    c->setContextProperty("Cpp_Misc_Watchdog", nullptr);
+    c->setContextProperty("Cpp_SerialStudio_SessionRecorder", nullptr);
+    c->setContextProperty("Cpp_Telemetry_Analytics", nullptr);
+    c->setContextProperty("Cpp_Telemetry_CsvWriter", nullptr);
+    c->setContextProperty("Cpp_Mission_Timeline", nullptr);
+    c->setContextProperty("Cpp_Mission_RuleEngine", nullptr);
+    c->setContextProperty("Cpp_Mission_ProfileLibrary", nullptr);
     c->setContextProperty("Cpp_Misc_Utilities", utilities);
     c->setContextProperty("Cpp_AppIcon", "qrc" APP_ICON);
     c->setContextProperty("Cpp_AppName", app.applicationName());
     c->setContextProperty("Cpp_AppUpdaterUrl", APP_UPDATER_URL);
     c->setContextProperty("Cpp_Misc_TimerEvents", timerEvents);
+    c->setContextProperty("Cpp_Misc_RenderStats", renderStats);
     c->setContextProperty("Cpp_AppVersion", app.applicationVersion());
     c->setContextProperty("Cpp_AppOrganization", app.organizationName());
     c->setContextProperty("Cpp_SerialStudio_Communicator", ssCommunicator);
+    c->setContextProperty("Cpp_SerialStudio_CommandTracker", ssCommandTracker);
     c->setContextProperty("Cpp_AppOrganizationDomain", app.organizationDomain());
+
+    // Load QML interface
     engine.load(QUrl(QStringLiteral("qrc:/qml/main.qml")));
 
     // Log QML engine status
     LOG_INFO() << "Finished loading QML interface";
+    trace->mark("QML interface loaded");
 
     // QML error, exit
     if (engine.rootObjects().isEmpty())
@@ -125,18 +259,61 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 
-    // Start timer subsystem
-    Misc::TimerEvents::getInstance()->startTimers();
+    // Start timer subsystem, simulations can run faster than real time with
+    // the --virtual-time argument
+    if (app.arguments().contains("--virtual-time"))
+        timerEvents->setVirtualTime(true);
+    timerEvents->startTimers();
 
-    // Configure the updater
-    LOG_INFO() << "Configuring QSimpleUpdater...";
-    updater->setNotifyOnUpdate(APP_UPDATER_URL, true);
-    updater->setNotifyOnFinish(APP_UPDATER_URL, false);
-    updater->setMandatoryUpdate(APP_UPDATER_URL, false);
-    LOG_INFO() << "QSimpleUpdater configuration finished!";
+    // Measure the throughput of the communication pipeline with the --stress argument
+    if (SerialStudio::StressTest::requested())
+    {
+        auto stressTest = SerialStudio::StressTest::getInstance();
+        QTimer::singleShot(0, stressTest, &SerialStudio::StressTest::start);
+    }
+
+    // Initialize non-critical modules after the first frame has been rendered. The
+    // frameSwapped() signal is emitted by the render thread, so we use the trace object
+    // as context to get the call in the main thread.
+    auto enginePtr = &engine;
+    auto window = qobject_cast<QQuickWindow *>(engine.rootObjects().first());
+    if (window)
+    {
+        renderStats->attach(window);
+        auto connection = std::make_shared<QMetaObject::Connection>();
+        *connection = QObject::connect(
+            window, &QQuickWindow::frameSwapped, trace,
+            [=]() {
+                QObject::disconnect(*connection);
+                trace->mark("First frame");
+                initTelemetryModules(enginePtr);
+                QTimer::singleShot(DEFERRED_INIT_DELAY, trace,
+                                   [=]() { initDeferredModules(enginePtr); });
+                QTimer::singleShot(STARTUP_TRACE_DURATION, trace,
+                                   &Misc::StartupTrace::finish);
+            },
+            Qt::QueuedConnection);
+    }
+
+    // Something went wrong, initialize non-critical modules anyway
+    else
+    {
+        initTelemetryModules(enginePtr);
+        initDeferredModules(enginePtr);
+    }
 
     // Enter application event loop
     auto code = app.exec();
     LOG_INFO() << "Application exit code" << code;
+
+    // Save profiler events
+    if (Misc::Profiler::enabled())
+    {
+        if (Misc::Profiler::exportTrace(PROFILER_TRACE_FILE))
+            LOG_INFO() << "Profiler trace saved to" << PROFILER_TRACE_FILE;
+        else
+            LOG_WARNING() << "Cannot save profiler trace to" << PROFILER_TRACE_FILE;
+    }
+
     return code;
 }
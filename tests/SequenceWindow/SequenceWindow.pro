@@ -0,0 +1,37 @@
+#-------------------------------------------------------------------------------
+# Make options
+#-------------------------------------------------------------------------------
+
+UI_DIR = uic
+MOC_DIR = moc
+RCC_DIR = qrc
+OBJECTS_DIR = obj
+
+CONFIG += c++11
+
+#-------------------------------------------------------------------------------
+# Qt configuration
+#-------------------------------------------------------------------------------
+
+TEMPLATE = app
+TARGET = tst_sequencewindow
+
+CONFIG += console
+CONFIG += testcase
+CONFIG -= app_bundle
+
+QT += core
+QT += testlib
+
+#-------------------------------------------------------------------------------
+# Import source code
+#-------------------------------------------------------------------------------
+
+INCLUDEPATH += $$PWD/../../src
+
+HEADERS += \
+    ../../src/Telemetry/SequenceWindow.h
+
+SOURCES += \
+    TestSequenceWindow.cpp \
+    ../../src/Telemetry/SequenceWindow.cpp
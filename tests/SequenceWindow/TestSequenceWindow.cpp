@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtTest>
+
+#include <Telemetry/SequenceWindow.h>
+
+using Telemetry::SequenceWindow;
+
+/**
+ * Checks that the sequence window discards the copies of a packet while keeping every
+ * packet sent after a reset of the packet counter
+ */
+class TestSequenceWindow : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rejectsDuplicates();
+    void acceptsLatePackets();
+    void acceptsCounterReset();
+    void acceptsCounterResetAfterSilence();
+};
+
+/**
+ * Copies of a packet received through another link are rejected
+ */
+void TestSequenceWindow::rejectsDuplicates()
+{
+    SequenceWindow window;
+    QVERIFY(window.accept(10, 0));
+    QVERIFY(!window.accept(10, 5));
+    QVERIFY(window.accept(11, 1000));
+    QVERIFY(!window.accept(10, 1010));
+    QVERIFY(!window.accept(11, 1020));
+}
+
+/**
+ * Packets that arrive out of order are accepted once
+ */
+void TestSequenceWindow::acceptsLatePackets()
+{
+    SequenceWindow window;
+    QVERIFY(window.accept(100, 0));
+    QVERIFY(window.accept(102, 2000));
+    QVERIFY(window.accept(101, 2010));
+    QVERIFY(!window.accept(101, 2020));
+}
+
+/**
+ * After the packet counter goes back from ~500 to 1, every new packet is accepted
+ */
+void TestSequenceWindow::acceptsCounterReset()
+{
+    SequenceWindow window;
+    qint64 time = 0;
+    for (quint32 i = 1; i <= 500; ++i, time += 1000)
+        QVERIFY(window.accept(i, time));
+
+    for (quint32 i = 1; i <= 1000; ++i, time += 1000)
+        QVERIFY2(window.accept(i, time), qPrintable(QString::number(i)));
+
+    QVERIFY(!window.accept(1000, time));
+}
+
+/**
+ * A reset that falls inside the window is detected after the source was silent
+ */
+void TestSequenceWindow::acceptsCounterResetAfterSilence()
+{
+    SequenceWindow window;
+    qint64 time = 0;
+    for (quint32 i = 1; i <= 30; ++i, time += 1000)
+        QVERIFY(window.accept(i, time));
+
+    // Processor restarts, telemetry resumes a few seconds later
+    time += 5000;
+    for (quint32 i = 1; i <= 30; ++i, time += 1000)
+        QVERIFY2(window.accept(i, time), qPrintable(QString::number(i)));
+
+    QVERIFY(!window.accept(30, time));
+}
+
+QTEST_GUILESS_MAIN(TestSequenceWindow)
+#include "TestSequenceWindow.moc"
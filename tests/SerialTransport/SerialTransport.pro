@@ -0,0 +1,56 @@
+#-------------------------------------------------------------------------------
+# Make options
+#-------------------------------------------------------------------------------
+
+UI_DIR = uic
+MOC_DIR = moc
+RCC_DIR = qrc
+OBJECTS_DIR = obj
+
+CONFIG += c++11
+
+#-------------------------------------------------------------------------------
+# Qt configuration
+#-------------------------------------------------------------------------------
+
+TEMPLATE = app
+TARGET = tst_serialtransport
+
+CONFIG += console
+CONFIG += testcase
+CONFIG -= app_bundle
+
+QT += core
+QT += network
+QT += testlib
+QT += serialport
+
+#-------------------------------------------------------------------------------
+# Libraries
+#-------------------------------------------------------------------------------
+
+DEFINES += CUTELOGGER_SRC
+include($$PWD/../../libs/CuteLogger/CuteLogger.pri)
+
+#-------------------------------------------------------------------------------
+# Import source code
+#-------------------------------------------------------------------------------
+
+INCLUDEPATH += $$PWD/../../src
+
+HEADERS += \
+    ../../src/SerialStudio/LocalTransport.h \
+    ../../src/SerialStudio/LoopbackTransport.h \
+    ../../src/SerialStudio/SerialTransport.h \
+    ../../src/SerialStudio/TcpTransport.h \
+    ../../src/SerialStudio/Transport.h \
+    ../../src/SerialStudio/UdpTransport.h
+
+SOURCES += \
+    TestSerialTransport.cpp \
+    ../../src/SerialStudio/LocalTransport.cpp \
+    ../../src/SerialStudio/LoopbackTransport.cpp \
+    ../../src/SerialStudio/SerialTransport.cpp \
+    ../../src/SerialStudio/TcpTransport.cpp \
+    ../../src/SerialStudio/Transport.cpp \
+    ../../src/SerialStudio/UdpTransport.cpp
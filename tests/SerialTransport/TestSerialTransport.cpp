@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtTest>
+
+#include <SerialStudio/Transport.h>
+
+#ifdef Q_OS_UNIX
+#    include <fcntl.h>
+#    include <stdlib.h>
+#    include <unistd.h>
+#endif
+
+using SerialStudio::Transport;
+
+/*
+ * Maximum time (in ms) to wait for the reader thread
+ */
+#define TIMEOUT 2000
+
+/**
+ * Drives the serial transport through a pseudo-terminal pair, the transport opens the
+ * slave side & the test plays the role of the radio on the master side.
+ */
+class TestSerialTransport : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void opensSlave();
+    void writesToRadio();
+    void readsFromRadio();
+    void reportsOpenFailure();
+
+private:
+    QByteArray readMaster();
+
+private:
+    int m_master;
+    QString m_slave;
+    QScopedPointer<Transport> m_transport;
+};
+
+/**
+ * Isolates the settings of the test from the ones of the application
+ */
+void TestSerialTransport::initTestCase()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("Pseudo-terminals are only available on Unix systems");
+#endif
+
+    QCoreApplication::setOrganizationName("CC2021 Tests");
+    QCoreApplication::setApplicationName("tst_serialtransport");
+}
+
+/**
+ * Creates a new pseudo-terminal pair & a serial transport for each test
+ */
+void TestSerialTransport::init()
+{
+    m_master = -1;
+#ifdef Q_OS_UNIX
+    m_master = posix_openpt(O_RDWR | O_NOCTTY);
+    QVERIFY(m_master >= 0);
+    QCOMPARE(grantpt(m_master), 0);
+    QCOMPARE(unlockpt(m_master), 0);
+    QCOMPARE(fcntl(m_master, F_SETFL, O_NONBLOCK), 0);
+    m_slave = ptsname(m_master);
+#endif
+
+    m_transport.reset(Transport::create(Transport::Type::Serial));
+}
+
+/**
+ * Closes the transport & the pseudo-terminal
+ */
+void TestSerialTransport::cleanup()
+{
+    m_transport.reset();
+
+#ifdef Q_OS_UNIX
+    if (m_master >= 0)
+        ::close(m_master);
+#endif
+}
+
+/**
+ * The transport reports the connection once the reader thread opened the port
+ */
+void TestSerialTransport::opensSlave()
+{
+    QSignalSpy spy(m_transport.data(), &Transport::connectedChanged);
+    m_transport->open(m_slave, 0);
+    QTRY_VERIFY_WITH_TIMEOUT(m_transport->isConnected(), TIMEOUT);
+    QCOMPARE(spy.count(), 1);
+
+    m_transport->close();
+    QVERIFY(!m_transport->isConnected());
+    QCOMPARE(spy.count(), 2);
+}
+
+/**
+ * Frames written to the transport reach the radio unchanged
+ */
+void TestSerialTransport::writesToRadio()
+{
+    m_transport->open(m_slave, 0);
+    QTRY_VERIFY_WITH_TIMEOUT(m_transport->isConnected(), TIMEOUT);
+
+    const QByteArray frame = "CMD,1714,CX,ON;\n\n\n\n\n\n\n";
+    QCOMPARE(m_transport->write(frame), qint64(frame.size()));
+
+    QByteArray received;
+    QTRY_VERIFY_WITH_TIMEOUT((received += readMaster()) == frame, TIMEOUT);
+}
+
+/**
+ * Data sent by the radio is forwarded by the transport unchanged
+ */
+void TestSerialTransport::readsFromRadio()
+{
+    m_transport->open(m_slave, 0);
+    QTRY_VERIFY_WITH_TIMEOUT(m_transport->isConnected(), TIMEOUT);
+
+    QByteArray received;
+    connect(m_transport.data(), &Transport::dataReceived,
+            [&](const QByteArray &data) { received.append(data); });
+
+    const QByteArray line = "1714,00:01:32,10,C,F,N,N,N,N,645.1,23.4,8.7\r\n";
+#ifdef Q_OS_UNIX
+    QCOMPARE(::write(m_master, line.constData(), static_cast<size_t>(line.size())),
+             static_cast<ssize_t>(line.size()));
+#endif
+
+    QTRY_COMPARE_WITH_TIMEOUT(received, line, TIMEOUT);
+}
+
+/**
+ * Ports that cannot be opened are reported as disconnected & can be retried
+ */
+void TestSerialTransport::reportsOpenFailure()
+{
+    m_transport->open("/dev/cc2021-missing-port", 0);
+    QTest::qWait(200);
+    QVERIFY(!m_transport->isConnected());
+
+    m_transport->open(m_slave, 0);
+    QTRY_VERIFY_WITH_TIMEOUT(m_transport->isConnected(), TIMEOUT);
+}
+
+/**
+ * Returns the data that is available on the master side of the pseudo-terminal
+ */
+QByteArray TestSerialTransport::readMaster()
+{
+    QByteArray data;
+#ifdef Q_OS_UNIX
+    char buffer[256];
+    ssize_t bytes;
+    while ((bytes = ::read(m_master, buffer, sizeof(buffer))) > 0)
+        data.append(buffer, static_cast<int>(bytes));
+#endif
+
+    return data;
+}
+
+QTEST_GUILESS_MAIN(TestSerialTransport)
+#include "TestSerialTransport.moc"
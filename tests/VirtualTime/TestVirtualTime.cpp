@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtTest>
+
+#include <Misc/TimerEvents.h>
+#include <SerialStudio/CommandTracker.h>
+
+using Misc::TimerEvents;
+using SerialStudio::CommandTracker;
+
+/**
+ * Checks that the timer signals & the modules that measure timeouts follow the virtual
+ * clock, so that a full simulation can be stepped through without waiting.
+ */
+class TestVirtualTime : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void advanceEmitsTimerSignals();
+    void clockFollowsVirtualTime();
+    void clockDoesNotGoBackwards();
+    void trackerRetriesInVirtualTime();
+    void trackerAcknowledgesAfterEchoChange();
+};
+
+/**
+ * Isolates the settings of the test from the ones of the application
+ */
+void TestVirtualTime::initTestCase()
+{
+    QCoreApplication::setOrganizationName("CC2021 Tests");
+    QCoreApplication::setApplicationName("tst_virtualtime");
+}
+
+/**
+ * Enables virtual time mode before each test
+ */
+void TestVirtualTime::init()
+{
+    TimerEvents::getInstance()->setVirtualTime(true);
+}
+
+/**
+ * Restores wall-clock mode after each test
+ */
+void TestVirtualTime::cleanup()
+{
+    TimerEvents::getInstance()->setVirtualTime(false);
+}
+
+/**
+ * Advancing one virtual second emits every signal as often as in real time
+ */
+void TestVirtualTime::advanceEmitsTimerSignals()
+{
+    auto te = TimerEvents::getInstance();
+    QSignalSpy spy1Hz(te, &TimerEvents::timeout1Hz);
+    QSignalSpy spy5Hz(te, &TimerEvents::timeout5Hz);
+    QSignalSpy spy42Hz(te, &TimerEvents::timeout42Hz);
+
+    te->advance(1000);
+    QCOMPARE(spy1Hz.count(), 1);
+    QCOMPARE(spy5Hz.count(), 5);
+    QVERIFY(spy42Hz.count() >= 42);
+}
+
+/**
+ * The clock only moves when virtual time is advanced
+ */
+void TestVirtualTime::clockFollowsVirtualTime()
+{
+    auto te = TimerEvents::getInstance();
+    const auto start = te->nsecsElapsed();
+    QTest::qWait(20);
+    QCOMPARE(te->nsecsElapsed(), start);
+
+    te->advance(5000);
+    QCOMPARE(te->nsecsElapsed() - start, Q_INT64_C(5000000000));
+    QCOMPARE(te->elapsed() - start / 1000000, Q_INT64_C(5000));
+}
+
+/**
+ * Leaving virtual time mode after running ahead of the wall clock does not move the
+ * clock backwards
+ */
+void TestVirtualTime::clockDoesNotGoBackwards()
+{
+    auto te = TimerEvents::getInstance();
+    te->advance(60 * 60 * 1000);
+    const auto virtualTime = te->nsecsElapsed();
+
+    te->setVirtualTime(false);
+    QVERIFY(te->nsecsElapsed() >= virtualTime);
+}
+
+/**
+ * Unacknowledged commands are retried & failed after the configured timeout of virtual
+ * time, without waiting for the wall clock
+ */
+void TestVirtualTime::trackerRetriesInVirtualTime()
+{
+    auto te = TimerEvents::getInstance();
+    auto tracker = CommandTracker::getInstance();
+    tracker->setAckTimeout(3000);
+    tracker->setMaxAttempts(2);
+
+    QSignalSpy retries(tracker, &CommandTracker::retryRequested);
+    QVERIFY(tracker->track("CMD,1714,SP1X,ON;"));
+    QCOMPARE(tracker->pendingCount(), 1);
+
+    // Not due yet
+    te->advance(2800);
+    QCOMPARE(retries.count(), 0);
+
+    // First timeout, command is sent again
+    te->advance(400);
+    QCOMPARE(retries.count(), 1);
+    QCOMPARE(retries.first().first().toString(), QString("CMD,1714,SP1X,ON;"));
+    QCOMPARE(tracker->pendingCount(), 1);
+
+    // Second timeout, maximum number of attempts reached
+    te->advance(3200);
+    QCOMPARE(retries.count(), 1);
+    QCOMPARE(tracker->pendingCount(), 0);
+}
+
+/**
+ * A command sent after the last echo change is acknowledged by the next echo change,
+ * but not by the stale echo that the container keeps repeating
+ */
+void TestVirtualTime::trackerAcknowledgesAfterEchoChange()
+{
+    auto te = TimerEvents::getInstance();
+    auto tracker = CommandTracker::getInstance();
+    tracker->setAckTimeout(3000);
+    tracker->setMaxAttempts(2);
+
+    // Container reports an older command
+    tracker->processEcho("SP2XON");
+    te->advance(500);
+
+    // New command is sent after the last echo change
+    QVERIFY(tracker->track("CMD,1714,SP1X,OFF;"));
+    QCOMPARE(tracker->pendingCount(), 1);
+
+    // Stale echo is repeated
+    te->advance(500);
+    tracker->processEcho("SP2XON");
+    QCOMPARE(tracker->pendingCount(), 1);
+
+    // Echo changes to the new command
+    te->advance(500);
+    tracker->processEcho("SP1XOFF");
+    QCOMPARE(tracker->pendingCount(), 0);
+
+    // Latest command is shown in the first row
+    const auto index = tracker->index(0);
+    QCOMPARE(tracker->data(index, CommandTracker::StateRole).toInt(),
+             static_cast<int>(CommandTracker::Acknowledged));
+}
+
+QTEST_GUILESS_MAIN(TestVirtualTime)
+#include "TestVirtualTime.moc"
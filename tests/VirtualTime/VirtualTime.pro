@@ -0,0 +1,54 @@
+#-------------------------------------------------------------------------------
+# Make options
+#-------------------------------------------------------------------------------
+
+UI_DIR = uic
+MOC_DIR = moc
+RCC_DIR = qrc
+OBJECTS_DIR = obj
+
+CONFIG += c++11
+
+#-------------------------------------------------------------------------------
+# Qt configuration
+#-------------------------------------------------------------------------------
+
+TEMPLATE = app
+TARGET = tst_virtualtime
+
+CONFIG += console
+CONFIG += testcase
+CONFIG -= app_bundle
+
+QT += core
+QT += network
+QT += testlib
+QT += widgets
+
+#-------------------------------------------------------------------------------
+# Libraries
+#-------------------------------------------------------------------------------
+
+DEFINES += CUTELOGGER_SRC
+include($$PWD/../../libs/CuteLogger/CuteLogger.pri)
+
+#-------------------------------------------------------------------------------
+# Import source code
+#-------------------------------------------------------------------------------
+
+INCLUDEPATH += $$PWD/../../src
+
+HEADERS += \
+    ../../src/Misc/Metrics.h \
+    ../../src/Misc/MetricsServer.h \
+    ../../src/Misc/TimerEvents.h \
+    ../../src/SerialStudio/CommandTracker.h \
+    ../../src/SerialStudio/XBee.h
+
+SOURCES += \
+    TestVirtualTime.cpp \
+    ../../src/Misc/Metrics.cpp \
+    ../../src/Misc/MetricsServer.cpp \
+    ../../src/Misc/TimerEvents.cpp \
+    ../../src/SerialStudio/CommandTracker.cpp \
+    ../../src/SerialStudio/XBee.cpp
@@ -0,0 +1,10 @@
+#-------------------------------------------------------------------------------
+# Unit tests, build with qmake tests/tests.pro & run with make check
+#-------------------------------------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    SequenceWindow \
+    SerialTransport \
+    VirtualTime